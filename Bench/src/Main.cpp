@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+#include <Chess.hpp>
+
+int main(int argc, char** argv) {
+    int depth = Chess::Bench::k_defaultDepth;
+    bool forceMagic = false;
+    auto strategy = Chess::Searcher::MoveStrategy::MakeUnmake;
+    std::string_view network{};
+    std::string_view tracePath{};
+    uint64_t traceNodes = 10'000'000;
+    for (int i = 1; i < argc; i++) {
+        if (std::string_view{ argv[i] } == "--magic") {
+            forceMagic = true;
+        }
+        else if (std::string_view{ argv[i] } == "--copy-make") {
+            strategy = Chess::Searcher::MoveStrategy::CopyMake;
+        }
+        else if (std::string_view{ argv[i] } == "--nnue" && i + 1 < argc) {
+            network = argv[++i];
+        }
+        else if (std::string_view{ argv[i] } == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        }
+        else if (std::string_view{ argv[i] } == "--trace-nodes" && i + 1 < argc) {
+            traceNodes = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else {
+            depth = std::atoi(argv[i]);
+        }
+    }
+    if (depth <= 0) {
+        std::cerr << "Usage: Bench [depth] [--magic] [--copy-make] [--nnue file]\n"
+            "             [--trace file] [--trace-nodes n (default 10000000)]\n";
+        return 1;
+    }
+
+    Chess::init();
+    if (forceMagic) {
+        Chess::PregeneratedMoves::init(Chess::PregeneratedMoves::SliderIndexing::Magic);
+    }
+    std::cout << "Slider attacks: " << (Chess::PregeneratedMoves::getSliderIndexing() ==
+        Chess::PregeneratedMoves::SliderIndexing::Pext ? "pext" : "magic") << '\n';
+    if (!network.empty()) {
+        try {
+            Chess::Nnue::load(network);
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+    std::cout << "Move strategy : " << (strategy ==
+        Chess::Searcher::MoveStrategy::CopyMake ? "copy-make" : "make/unmake") << '\n';
+    std::cout << "Evaluation    : " << (Chess::Nnue::isLoaded() ? "nnue" : "hand written")
+        << "\n\n";
+
+    Chess::Searcher searcher{};
+    searcher.setMoveStrategy(strategy);
+    if (!tracePath.empty()) {
+        try {
+            searcher.startTrace(tracePath, traceNodes);
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+    Chess::Bench::run(searcher, depth);
+    searcher.stopTrace();
+    return 0;
+}
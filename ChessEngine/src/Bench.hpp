@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+#include "Searcher.hpp"
+
+namespace Chess {
+    namespace Bench {
+        inline constexpr int k_defaultDepth = 6;
+
+        struct Result {
+            uint64_t nodes;
+            double seconds;
+            uint64_t nodesPerSecond;
+            // mean cost of one static evaluation with a warm pawn table
+            double evalNanoseconds;
+            // share of stand pat evaluations answered by the evaluation cache,
+            // and at most how much evaluation time that spared net of the probes
+            double evalCacheHitRate;
+            double evalSecondsSaved;
+        };
+
+        // Searches a fixed set of positions to a fixed depth, each with a
+        // freshly cleared searcher. The node total doubles as a signature of
+        // search behavior: a pure speed change must leave it untouched, and
+        // both move strategies must give the same one.
+        Result run(int depth = k_defaultDepth,
+            Searcher::MoveStrategy strategy = Searcher::MoveStrategy::MakeUnmake,
+            std::ostream& out = std::cout);
+        // as run, with a searcher the caller has set up, for example to
+        // record a trace of the bench searches
+        Result run(Searcher& searcher, int depth = k_defaultDepth,
+            std::ostream& out = std::cout);
+    }  // namespace Bench
+}
@@ -60,17 +60,17 @@ namespace Chess
 
         constexpr uint64_t get() const { return m_encoding; }
 
-        void setBit(uint8_t square) { m_encoding |= (1ULL << square); }
+        constexpr void setBit(uint8_t square) { m_encoding |= (1ULL << square); }
 
-        void clearBit(uint8_t square) { m_encoding &= ~(1ULL << square); }
+        constexpr void clearBit(uint8_t square) { m_encoding &= ~(1ULL << square); }
 
         constexpr uint8_t getLSBIndex() const {
             return static_cast<uint8_t>(std::countr_zero(m_encoding));
         }
 
-        void clearLSB() { m_encoding &= (m_encoding - 1); };
+        constexpr void clearLSB() { m_encoding &= (m_encoding - 1); };
 
-        uint8_t popLSB() {
+        constexpr uint8_t popLSB() {
             uint8_t square = getLSBIndex();
             clearLSB();
             return square;
@@ -80,21 +80,31 @@ namespace Chess
             return m_encoding & (1ULL << square);
         }
 
+        // Without a popcnt instruction to target, std::popcount becomes a
+        // call into the runtime library, which costs more than counting in
+        // registers
         constexpr uint8_t numBits() const {
+#ifdef __POPCNT__
             return static_cast<uint8_t>(std::popcount(m_encoding));
+#else
+            uint64_t x = m_encoding - ((m_encoding >> 1) & 0x5555555555555555ULL);
+            x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return static_cast<uint8_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
         }
 
         constexpr Bitboard operator|(Bitboard other) const {
             return Bitboard{ m_encoding | other.m_encoding };
         }
 
-        void operator|=(Bitboard other) { m_encoding |= other.m_encoding; }
+        constexpr void operator|=(Bitboard other) { m_encoding |= other.m_encoding; }
 
         constexpr Bitboard operator&(Bitboard other) const {
             return Bitboard{ m_encoding & other.m_encoding };
         }
 
-        void operator&=(Bitboard other) { m_encoding &= other.m_encoding; }
+        constexpr void operator&=(Bitboard other) { m_encoding &= other.m_encoding; }
 
         constexpr Bitboard operator~() const { return Bitboard{ ~m_encoding }; }
 
@@ -102,13 +112,13 @@ namespace Chess
             return Bitboard{ m_encoding << shift };
         }
 
-        void operator<<=(int shift) { m_encoding <<= shift; }
+        constexpr void operator<<=(int shift) { m_encoding <<= shift; }
 
         constexpr Bitboard operator>>(int shift) const {
             return Bitboard{ m_encoding >> shift };
         }
 
-        void operator>>=(int shift) { m_encoding >>= shift; }
+        constexpr void operator>>=(int shift) { m_encoding >>= shift; }
 
         constexpr uint64_t operator*(uint64_t num) const { return m_encoding * num; }
 
@@ -1,19 +1,26 @@
 #pragma once
 
+#include "Bench.hpp"
 #include "Bitboard.hpp"
+#include "GameHistory.hpp"
 #include "Searcher.hpp"
+#include "SearchTrace.hpp"
 #include "Move.hpp"
+#include "Nnue.hpp"
 #include "Position.hpp"
 #include "Utils.hpp"
+#include "Perft.hpp"
 #include "Piece.hpp"
 #include "Zobrist.hpp"
 #include "PregeneratedMoves.hpp"
 #include "MoveGenerator.hpp"
 #include "SquareAliases.hpp"
+#include "ThreadPool.hpp"
 
 namespace Chess {
+	// Lookup tables and Zobrist keys are compile time constants, this only
+	// picks the fastest slider indexing for the running CPU
 	inline void init() {
-		Zobrist::init();
 		PregeneratedMoves::init();
 	}
 }
@@ -0,0 +1,92 @@
+#include "Cpu.hpp"
+
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define CHESS_X86_64
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <cpuid.h>
+#define CHESS_X86_64
+#endif
+
+using namespace Chess;
+
+namespace {
+#ifdef CHESS_X86_64
+    struct CpuidResult {
+        unsigned int eax, ebx, ecx, edx;
+    };
+
+    CpuidResult cpuid(unsigned int leaf, unsigned int subleaf) {
+        CpuidResult result{};
+#ifdef _MSC_VER
+        int regs[4];
+        __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+        result = { static_cast<unsigned int>(regs[0]), static_cast<unsigned int>(regs[1]),
+                   static_cast<unsigned int>(regs[2]), static_cast<unsigned int>(regs[3]) };
+#else
+        __cpuid_count(leaf, subleaf, result.eax, result.ebx, result.ecx, result.edx);
+#endif
+        return result;
+    }
+
+    bool isAmd() {
+        const CpuidResult vendor = cpuid(0, 0);
+        char name[12];
+        std::memcpy(name, &vendor.ebx, 4);
+        std::memcpy(name + 4, &vendor.edx, 4);
+        std::memcpy(name + 8, &vendor.ecx, 4);
+        return std::memcmp(name, "AuthenticAMD", 12) == 0;
+    }
+
+    // XCR0, which says what register state the OS saves
+    unsigned long long xgetbv0() {
+#ifdef _MSC_VER
+        return _xgetbv(0);
+#else
+        unsigned int eax = 0;
+        unsigned int edx = 0;
+        __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+    }
+
+    unsigned int family() {
+        const unsigned int eax = cpuid(1, 0).eax;
+        const unsigned int base = (eax >> 8) & 0xF;
+        return base == 0xF ? base + ((eax >> 20) & 0xFF) : base;
+    }
+#endif
+}  // namespace
+
+bool Cpu::hasBmi2() {
+#ifdef CHESS_X86_64
+    if (cpuid(0, 0).eax < 7) return false;
+    return cpuid(7, 0).ebx & (1u << 8);
+#else
+    return false;
+#endif
+}
+
+bool Cpu::hasFastPext() {
+#ifdef CHESS_X86_64
+    // family 0x19 is Zen 3
+    return hasBmi2() && !(isAmd() && family() < 0x19);
+#else
+    return false;
+#endif
+}
+
+bool Cpu::hasAvx2() {
+#ifdef CHESS_X86_64
+    if (cpuid(0, 0).eax < 7) return false;
+    // OSXSAVE and AVX, then SSE and AVX state enabled in XCR0
+    const unsigned int ecx = cpuid(1, 0).ecx;
+    if ((ecx & (1u << 27)) == 0 || (ecx & (1u << 28)) == 0) return false;
+    if ((xgetbv0() & 0b110) != 0b110) return false;
+    return cpuid(7, 0).ebx & (1u << 5);
+#else
+    return false;
+#endif
+}
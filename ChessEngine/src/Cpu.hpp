@@ -0,0 +1,14 @@
+#pragma once
+
+namespace Chess {
+    // Runtime CPU feature detection, so one binary can pick the fastest code
+    // path on whatever machine it lands on. Always false off x86-64.
+    namespace Cpu {
+        bool hasBmi2();
+        // BMI2 where PEXT is implemented in hardware; AMD before Zen 3 runs it
+        // in microcode at a fraction of the speed of a magic multiply
+        bool hasFastPext();
+        // AVX2 with the OS saving the 256 bit registers across context switches
+        bool hasAvx2();
+    }  // namespace Cpu
+}
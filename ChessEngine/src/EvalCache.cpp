@@ -0,0 +1,18 @@
+#include "EvalCache.hpp"
+
+using namespace Chess;
+
+EvalCache::EvalCache(size_t kilobytes) {
+    size_t size = 1;
+    while (2 * size * sizeof(uint64_t) <= (kilobytes << 10)) {
+        size *= 2;
+    }
+    m_slots = std::make_unique<std::atomic<uint64_t>[]>(size);
+    m_mask = size - 1;
+}
+
+void EvalCache::clear() {
+    for (size_t i = 0; i <= m_mask; i++) {
+        m_slots[i].store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "Zobrist.hpp"
+
+namespace Chess {
+    // Static evaluations by Zobrist key, direct mapped. A slot is one atomic
+    // word holding the upper 48 bits of the key and the 16 bit score, so a
+    // cache can be shared by several searchers without locks and a racing
+    // write can never pair one position's key with another's score. Scores
+    // are from the side to move, which the key includes.
+    class EvalCache {
+    public:
+        static constexpr size_t k_defaultKilobytes = 1024;
+
+        // rounded down to a power of two slots, at least one
+        explicit EvalCache(size_t kilobytes = k_defaultKilobytes);
+
+        std::optional<int> probe(Zobrist key) const {
+            const uint64_t data =
+                m_slots[index(key)].load(std::memory_order_relaxed);
+            if ((data ^ key.get()) & k_keyMask) {
+                return std::nullopt;
+            }
+            return static_cast<int16_t>(data & ~k_keyMask);
+        }
+
+        // scores beyond 16 bits are not cached
+        void store(Zobrist key, int score) {
+            if (score < INT16_MIN || score > INT16_MAX) {
+                return;
+            }
+            const uint64_t data = (key.get() & k_keyMask) |
+                static_cast<uint16_t>(static_cast<int16_t>(score));
+            m_slots[index(key)].store(data, std::memory_order_relaxed);
+        }
+
+        void clear();
+        size_t size() const { return m_mask + 1; }
+
+    private:
+        static constexpr uint64_t k_keyMask = ~0xFFFFULL;
+
+        // An empty slot matches only keys whose upper 48 bits are all zero
+        std::unique_ptr<std::atomic<uint64_t>[]> m_slots;
+        size_t m_mask;
+
+        size_t index(Zobrist key) const { return key.get() & m_mask; }
+    };
+}
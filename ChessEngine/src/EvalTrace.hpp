@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EvalWeights.hpp"
+#include "Piece.hpp"
+#include "Score.hpp"
+#include "TunedWeights.hpp"
+#include "DataStructures.hpp"
+
+namespace Chess {
+    // The evaluation of a position taken apart for tuning: how often each
+    // weight applies, white's count minus black's, and the rest of the
+    // evaluation, which is not linear in any weight. Summing the weights
+    // times their coefficients plus the rest and tapering by the phase gives
+    // the evaluation back.
+    struct EvalTrace {
+        Array<int16_t, EvalWeights::k_numScores> coefficients{};
+        Score nonlinear{};
+        int phase{ 0 };
+    };
+
+    // Evaluation terms are written once against a sink. ScoreSink sums them
+    // into a score from white's side, TraceSink records them in an EvalTrace.
+    struct ScoreSink {
+        Score score{};
+
+        template <PieceColor Us>
+        void add(const Score& weight, int count = 1) {
+            if constexpr (Us == PieceColor::White) score += weight * count;
+            else score -= weight * count;
+        }
+
+        template <PieceColor Us>
+        void addNonlinear(Score value) {
+            if constexpr (Us == PieceColor::White) score += value;
+            else score -= value;
+        }
+    };
+
+    // weight must be a field of EvalWeights::weights
+    struct TraceSink {
+        EvalTrace& trace;
+
+        template <PieceColor Us>
+        void add(const Score& weight, int count = 1) {
+            trace.coefficients[EvalWeights::indexOf(EvalWeights::weights, weight)] +=
+                Us == PieceColor::White ? count : -count;
+        }
+
+        template <PieceColor Us>
+        void addNonlinear(Score value) {
+            if constexpr (Us == PieceColor::White) trace.nonlinear += value;
+            else trace.nonlinear -= value;
+        }
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "Score.hpp"
+#include "DataStructures.hpp"
+
+namespace Chess {
+    // Every linear term of the hand written evaluation. The values live in
+    // TunedWeights.hpp, which the Tuner tool regenerates.
+    namespace EvalWeights {
+        struct Weights {
+            // by PieceType, the king's is never counted
+            Array<Score, 6> material;
+            // by PieceType then square from white's side, a8 first
+            Array2D<Score, 6, 64> pieceSquares;
+            Score doubledPawn;
+            Score isolatedPawn;
+            Score backwardPawn;
+            // by rank counted from the pawn's own side
+            Array<Score, 8> passedPawn;
+            // by PieceType, per square reached beyond the piece's baseline
+            Array<Score, 6> mobility;
+            // enemy pieces attacked by a pawn, enemy rooks and queens by a minor
+            Score threatByPawn;
+            Score threatByMinor;
+        };
+
+        inline constexpr size_t k_numScores = sizeof(Weights) / sizeof(Score);
+        static_assert(sizeof(Weights) == k_numScores * sizeof(Score));
+
+        // A field of Weights as a run of Scores, for tools that treat the
+        // weights as one flat vector
+        struct Parameter {
+            std::string_view name;
+            size_t offset;
+            size_t size;
+        };
+
+        // in declaration order, covering every Score of Weights exactly once
+        inline constexpr Array<Parameter, 9> parameters = { {
+            { "material", offsetof(Weights, material) / sizeof(Score), 6 },
+            { "pieceSquares", offsetof(Weights, pieceSquares) / sizeof(Score), 6 * 64 },
+            { "doubledPawn", offsetof(Weights, doubledPawn) / sizeof(Score), 1 },
+            { "isolatedPawn", offsetof(Weights, isolatedPawn) / sizeof(Score), 1 },
+            { "backwardPawn", offsetof(Weights, backwardPawn) / sizeof(Score), 1 },
+            { "passedPawn", offsetof(Weights, passedPawn) / sizeof(Score), 8 },
+            { "mobility", offsetof(Weights, mobility) / sizeof(Score), 6 },
+            { "threatByPawn", offsetof(Weights, threatByPawn) / sizeof(Score), 1 },
+            { "threatByMinor", offsetof(Weights, threatByMinor) / sizeof(Score), 1 } } };
+
+        // index of a Score of Weights in the flat vector
+        inline size_t indexOf(const Weights& weights, const Score& weight) {
+            return static_cast<size_t>(reinterpret_cast<const char*>(&weight) -
+                reinterpret_cast<const char*>(&weights)) / sizeof(Score);
+        }
+    }  // namespace EvalWeights
+}
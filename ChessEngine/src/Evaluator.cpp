@@ -1,40 +1,239 @@
 #include "Evaluator.hpp"
 
+#include <algorithm>
 #include <cstdint>
 
+#include "EvalTrace.hpp"
+#include "Nnue.hpp"
+#include "PawnTable.hpp"
 #include "Piece.hpp"
 #include "PieceTables.hpp"
 #include "Position.hpp"
+#include "PregeneratedMoves.hpp"
+#include "TunedWeights.hpp"
 
 using namespace Chess;
 
+namespace {
+    template <PieceColor Us>
+    constexpr PieceColor Them = oppositeColor(Us);
+
+    // by PieceType, squares reached that earn no EvalWeights mobility bonus
+    constexpr Array<int, 6> k_mobilityBaseline = { 0, 6, 4, 6, 12, 0 };
+
+    // by PieceType, per king zone square attacked
+    constexpr Array<int, 6> k_kingAttackWeights = { 0, 2, 2, 3, 5, 0 };
+    // a single attacker is rarely dangerous, and the penalty is capped so a
+    // king hunt never outweighs a rook
+    constexpr int k_minKingAttackers = 2;
+    constexpr int k_maxKingDanger = 500;
+
+    // How far the pawn structure plus the attack terms, and the attack
+    // terms alone, move a score in practice. Set above the largest swing
+    // seen over 100k positions, so lazy exits almost never change a result.
+    constexpr int k_lazyMargin = 400;
+    constexpr int k_pawnLazyMargin = 350;
+
+    // blend by how much non pawn material is left
+    int taper(Score score, int phase) {
+        return (score.middlegame() * phase +
+            score.endgame() * (PieceTables::k_maxPhase - phase)) / PieceTables::k_maxPhase;
+    }
+
+    template <PieceColor Us>
+    constexpr Bitboard pawnAttacks(Bitboard pawns) {
+        if constexpr (Us == PieceColor::White) return pawns.northEast() | pawns.northWest();
+        else return pawns.southEast() | pawns.southWest();
+    }
+
+    template <PieceColor Us>
+    void initEvalInfo(const Position& position, Evaluator::EvalInfo& info) {
+        constexpr uint8_t us = static_cast<uint8_t>(Us);
+        const uint8_t king = position.getBitboard(PieceType::King, Us).getLSBIndex();
+        const Bitboard kingMoves = PregeneratedMoves::getKingMoves(king);
+        const Bitboard pawns = pawnAttacks<Us>(position.getBitboard(PieceType::Pawn, Us));
+
+        info.attackedBy[static_cast<uint8_t>(PieceType::King)][us] = kingMoves;
+        info.attackedBy[static_cast<uint8_t>(PieceType::Pawn)][us] = pawns;
+        info.attacked[us] = kingMoves | pawns;
+        info.kingZone[us] = kingMoves | Bitboard::fromSquare(king);
+    }
+
+    // area holds the squares worth counting towards mobility
+    template <PieceColor Us, PieceType Type, typename Sink>
+    void evaluateMobility(const Position& position, Evaluator::EvalInfo& info,
+        Bitboard occupied, Bitboard area, Sink& sink) {
+        constexpr uint8_t us = static_cast<uint8_t>(Us);
+        constexpr uint8_t type = static_cast<uint8_t>(Type);
+        constexpr uint8_t them = static_cast<uint8_t>(Them<Us>);
+
+        Bitboard pieces = position.getBitboard(Type, Us);
+        while (pieces) {
+            const uint8_t square = pieces.popLSB();
+            Bitboard attacks{};
+            if constexpr (Type == PieceType::Knight) {
+                attacks = PregeneratedMoves::getKnightMoves(square);
+            }
+            else if constexpr (Type == PieceType::Bishop) {
+                attacks = PregeneratedMoves::getBishopMoves(square, occupied);
+            }
+            else if constexpr (Type == PieceType::Rook) {
+                attacks = PregeneratedMoves::getRookMoves(square, occupied);
+            }
+            else {
+                attacks = PregeneratedMoves::getQueenMoves(square, occupied);
+            }
+            info.attackedBy[type][us] |= attacks;
+            info.attacked[us] |= attacks;
+
+            if (const Bitboard kingHits = attacks & info.kingZone[them]) {
+                info.kingAttackers[us]++;
+                info.kingAttackWeight[us] += k_kingAttackWeights[type] * kingHits.numBits();
+            }
+            sink.template add<Us>(EvalWeights::weights.mobility[type],
+                (attacks & area).numBits() - k_mobilityBaseline[type]);
+        }
+    }
+
+    template <PieceColor Us, typename Sink>
+    void evaluatePieces(const Position& position, Evaluator::EvalInfo& info, Sink& sink) {
+        const Bitboard occupied = position.getColorBitboard(PieceColor::White) |
+            position.getColorBitboard(PieceColor::Black);
+        // not blocked by our own pawns or king and not covered by enemy pawns
+        const Bitboard area = ~(position.getBitboard(PieceType::Pawn, Us) |
+            position.getBitboard(PieceType::King, Us) |
+            info.attackedBy[static_cast<uint8_t>(PieceType::Pawn)][static_cast<uint8_t>(Them<Us>)]);
+        evaluateMobility<Us, PieceType::Knight>(position, info, occupied, area, sink);
+        evaluateMobility<Us, PieceType::Bishop>(position, info, occupied, area, sink);
+        evaluateMobility<Us, PieceType::Rook>(position, info, occupied, area, sink);
+        evaluateMobility<Us, PieceType::Queen>(position, info, occupied, area, sink);
+    }
+
+    // danger grows with the square of the attack weight, a middlegame only term
+    template <PieceColor Us, typename Sink>
+    void evaluateKing(const Evaluator::EvalInfo& info, Sink& sink) {
+        constexpr uint8_t them = static_cast<uint8_t>(Them<Us>);
+        if (info.kingAttackers[them] < k_minKingAttackers) {
+            return;
+        }
+        const int weight = info.kingAttackWeight[them];
+        sink.template addNonlinear<Us>(Score{ -std::min(weight * weight / 8, k_maxKingDanger), 0 });
+    }
+
+    // enemy pieces our pawns attack, and enemy rooks and queens our minors attack
+    template <PieceColor Us, typename Sink>
+    void evaluateThreats(const Position& position, const Evaluator::EvalInfo& info,
+        Sink& sink) {
+        constexpr uint8_t us = static_cast<uint8_t>(Us);
+        const Bitboard pieces = position.getColorBitboard(Them<Us>) &
+            ~position.getBitboard(PieceType::Pawn, Them<Us>) &
+            ~position.getBitboard(PieceType::King, Them<Us>);
+        const Bitboard majors = position.getBitboard(PieceType::Rook, Them<Us>) |
+            position.getBitboard(PieceType::Queen, Them<Us>);
+        const Bitboard minorAttacks =
+            info.attackedBy[static_cast<uint8_t>(PieceType::Knight)][us] |
+            info.attackedBy[static_cast<uint8_t>(PieceType::Bishop)][us];
+
+        sink.template add<Us>(EvalWeights::weights.threatByPawn,
+            (pieces & info.attackedBy[static_cast<uint8_t>(PieceType::Pawn)][us]).numBits());
+        sink.template add<Us>(EvalWeights::weights.threatByMinor,
+            (majors & minorAttacks).numBits());
+    }
+
+    // the terms that need attack information, shared by evaluate and trace
+    template <typename Sink>
+    void evaluateAttacks(const Position& position, Evaluator::EvalInfo& info, Sink& sink) {
+        info = Evaluator::EvalInfo{};
+        initEvalInfo<PieceColor::White>(position, info);
+        initEvalInfo<PieceColor::Black>(position, info);
+        // mobility fills in the attack sets the later terms read
+        evaluatePieces<PieceColor::White>(position, info, sink);
+        evaluatePieces<PieceColor::Black>(position, info, sink);
+        evaluateKing<PieceColor::White>(info, sink);
+        evaluateKing<PieceColor::Black>(info, sink);
+        evaluateThreats<PieceColor::White>(position, info, sink);
+        evaluateThreats<PieceColor::Black>(position, info, sink);
+    }
+}  // namespace
+
 int Evaluator::evaluatePiece(PieceType piece) {
-    static constexpr int evals[] = { 100, 310, 300, 500, 800, 0, 0 };
-    return evals[static_cast<uint8_t>(piece)];
+    return PieceTables::pieceValues[static_cast<uint8_t>(piece)];
+}
+
+int Evaluator::evaluate(const Position& position, PawnTable& pawnTable) {
+    EvalInfo info;
+    return evaluate(position, pawnTable, info);
 }
 
-int Evaluator::evaluatePieces(PieceType type, PieceColor color,
-    Bitboard pieces) {
-    int score = 0;
-    while (pieces) {
-        uint8_t square = pieces.popLSB();
-        score += evaluatePiece(type) + PieceTables::getValue(type, color, square);
+int Evaluator::evaluate(const Position& position, PawnTable& pawnTable, EvalInfo& info) {
+    if (position.usesNnue()) {
+        info = EvalInfo{};
+        return Nnue::evaluate(position.getAccumulator(), position.getTurn());
     }
-    return score;
+
+    // The position keeps the material and piece square sum up to date for
+    // both phases and the pawn table caches the pawn structure
+    ScoreSink sink{ position.getWhiteScore() + pawnTable.probe(position).score };
+    evaluateAttacks(position, info, sink);
+    const int score = taper(sink.score, std::min(position.getPhase(), PieceTables::k_maxPhase));
+    return position.getTurn() == PieceColor::White ? score : -score;
 }
 
-int Evaluator::evaluate(const Position& position) {
-    int score = 0;
+int Evaluator::evaluate(const Position& position, PawnTable& pawnTable, int alpha, int beta,
+    bool& complete) {
+    complete = false;
+    if (position.usesNnue()) {
+        complete = true;
+        return Nnue::evaluate(position.getAccumulator(), position.getTurn());
+    }
+
+    const int phase = std::min(position.getPhase(), PieceTables::k_maxPhase);
+    const int sign = position.getTurn() == PieceColor::White ? 1 : -1;
+    const auto decided = [alpha, beta](int score, int margin) {
+        return score - margin >= beta || score + margin <= alpha;
+    };
 
-    for (uint8_t i = 0; i < 6; i++) {
-        const PieceType type = static_cast<PieceType>(i);
-        const PieceColor color = position.getTurn();
-        score += evaluatePieces(type, color, position.getBitboard(type, color));
+    // material and piece squares are kept up to date by the position
+    Score whiteScore = position.getWhiteScore();
+    int score = sign * taper(whiteScore, phase);
+    if (decided(score, k_lazyMargin)) {
+        return score;
     }
-    for (uint8_t i = 0; i < 6; i++) {
-        const PieceType type = static_cast<PieceType>(i);
-        const PieceColor color = position.getOppositeTurn();
-        score -= evaluatePieces(type, color, position.getBitboard(type, color));
+
+    // usually a pawn table hit
+    whiteScore += pawnTable.probe(position).score;
+    score = sign * taper(whiteScore, phase);
+    if (decided(score, k_pawnLazyMargin)) {
+        return score;
     }
-    return score;
-}
\ No newline at end of file
+
+    EvalInfo info;
+    ScoreSink sink{ whiteScore };
+    evaluateAttacks(position, info, sink);
+    complete = true;
+    return sign * taper(sink.score, phase);
+}
+
+EvalTrace Evaluator::trace(const Position& position) {
+    EvalTrace trace{};
+    const EvalWeights::Weights& weights = EvalWeights::weights;
+    for (uint8_t type = 0; type < 6; type++) {
+        for (const PieceColor color : { PieceColor::White, PieceColor::Black }) {
+            const int sign = color == PieceColor::White ? 1 : -1;
+            Bitboard pieces = position.getBitboard(static_cast<PieceType>(type), color);
+            while (pieces) {
+                const uint8_t square = PieceTables::relativeSquare(color, pieces.popLSB());
+                trace.coefficients[EvalWeights::indexOf(weights, weights.material[type])] += sign;
+                trace.coefficients[EvalWeights::indexOf(weights,
+                    weights.pieceSquares[type][square])] += sign;
+            }
+        }
+    }
+    PawnTable::trace(position, trace);
+
+    EvalInfo info;
+    TraceSink sink{ trace };
+    evaluateAttacks(position, info, sink);
+    trace.phase = std::min(position.getPhase(), PieceTables::k_maxPhase);
+    return trace;
+}
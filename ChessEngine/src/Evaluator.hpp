@@ -2,13 +2,38 @@
 
 #include "Bitboard.hpp"
 #include "Piece.hpp"
+#include "DataStructures.hpp"
 
 namespace Chess {
 	class Position;
+	class PawnTable;
+	struct EvalTrace;
 
 	namespace Evaluator {
+		// Attack sets gathered while scoring mobility, so king safety and
+		// threats never look up an attack twice. Indexed by PieceColor.
+		struct EvalInfo {
+			// by PieceType then PieceColor
+			Array2D<Bitboard, 6, 2> attackedBy{};
+			Array<Bitboard, 2> attacked{};
+			// the king's square and its neighbours
+			Array<Bitboard, 2> kingZone{};
+			// pieces of a color hitting the enemy king zone and their summed weight
+			Array<int, 2> kingAttackers{};
+			Array<int, 2> kingAttackWeight{};
+		};
+
 		int evaluatePiece(PieceType type);
-		int evaluatePieces(PieceType type, PieceColor color, Bitboard pieces);
-		int evaluate(const Position& position);
+		int evaluate(const Position& position, PawnTable& pawnTable);
+		// as evaluate, leaving the attack sets it gathered in info
+		int evaluate(const Position& position, PawnTable& pawnTable, EvalInfo& info);
+		// Lazy evaluation for a search window. Stops after the cheap terms
+		// once the score is far enough outside [alpha, beta] that the rest is
+		// not expected to bring it back, and returns that partial score.
+		// complete tells whether every term was computed.
+		int evaluate(const Position& position, PawnTable& pawnTable, int alpha, int beta,
+			bool& complete);
+		// the hand written evaluation taken apart into its weights, for tuning
+		EvalTrace trace(const Position& position);
 	};  // namespace Evaluator
 }
@@ -0,0 +1,97 @@
+#include "GameHistory.hpp"
+
+#include <algorithm>
+
+#include "Bitboard.hpp"
+#include "Position.hpp"
+#include "PregeneratedMoves.hpp"
+
+using namespace Chess;
+
+GameHistory::GameHistory(const Position& start) { push(start); }
+
+void GameHistory::push(const Position& position) {
+    m_keys.push_back(position.getZobrist());
+}
+
+void GameHistory::pop() { m_keys.pop_back(); }
+
+void GameHistory::makeMove(Position& position, Move move) {
+    Position::UndoState undo{};
+    position.makeMove(move, undo);
+    push(position);
+}
+
+// the first index that can still match the last position
+int GameHistory::firstReversible(const Position& position) const {
+    return std::max(0, static_cast<int>(m_keys.size()) - 1 - position.getHalfMoveClock());
+}
+
+bool GameHistory::repeatsEarlier(int index, int first) const {
+    // it takes at least four plies to get back to a position
+    for (int i = index - 4; i >= first; i -= 2) {
+        if (m_keys[i] == m_keys[index]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GameHistory::isRepetitionDraw(const Position& position, int distance) const {
+    const int current = static_cast<int>(m_keys.size()) - 1;
+    const int root = current - distance;
+    const int first = firstReversible(position);
+    bool repeatedBeforeRoot = false;
+    for (int i = current - 4; i >= first; i -= 2) {
+        if (m_keys[i] != position.getZobrist()) continue;
+        if (i > root || repeatedBeforeRoot) {
+            return true;
+        }
+        repeatedBeforeRoot = true;
+    }
+    return false;
+}
+
+// Marcel van Kervinck's cycle detection: the key of a position an odd
+// number of plies back differs from ours by a single reversible move of
+// ours exactly when the moves in between cancel out up to that move.
+bool GameHistory::hasUpcomingRepetition(const Position& position, int distance) const {
+    const int current = static_cast<int>(m_keys.size()) - 1;
+    const int first = firstReversible(position);
+    if (current - first < 3) {
+        return false;
+    }
+
+    const Zobrist key = position.getZobrist();
+    // the opponent's moves since the compared position must cancel out
+    Zobrist opponentMoves{ key.get() ^ m_keys[current - 1].get() };
+    opponentMoves.toggleSide();
+    for (int i = 3; current - i >= first; i += 2) {
+        opponentMoves = Zobrist{ opponentMoves.get() ^ m_keys[current - i + 1].get() ^
+            m_keys[current - i].get() };
+        opponentMoves.toggleSide();
+        if (opponentMoves.get() != 0) continue;
+
+        const Move move = Zobrist::findReversibleMove(
+            Zobrist{ key.get() ^ m_keys[current - i].get() });
+        if (move == Move{}) continue;
+
+        const Bitboard path = PregeneratedMoves::getBetween(move.start(), move.target()) &
+            ~Bitboard::fromSquare(move.target());
+        if (path & position.getOccupied()) continue;
+
+        // the earlier position is inside the search
+        if (distance > i) {
+            return true;
+        }
+        // before the root the move has to be ours and the position has to
+        // have been repeated already
+        const Piece piece = position.getPieceAt(move.start()) ?
+            position.getPieceAt(move.start()) : position.getPieceAt(move.target());
+        if (piece.color != position.getTurn()) continue;
+        if (repeatsEarlier(current - i, first)) {
+            return true;
+        }
+    }
+    return false;
+}
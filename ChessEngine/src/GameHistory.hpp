@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Move.hpp"
+#include "Zobrist.hpp"
+
+namespace Chess {
+    class Position;
+
+    // Zobrist keys of every position a game went through, oldest first, with
+    // the current position last. Only repetition detection looks at the
+    // past, so this is all of it a game or a search has to keep.
+    class GameHistory {
+    public:
+        GameHistory() = default;
+        explicit GameHistory(const Position& start);
+
+        // records the position a move just reached
+        void push(const Position& position);
+        void pop();
+
+        // plays move on position and records where it leads
+        void makeMove(Position& position, Move move);
+
+        // Whether position, the last one recorded, counts as a draw by
+        // repetition for a search distance plies deep. One earlier occurrence
+        // is enough inside the search, before its root it takes two. Positions
+        // before the last capture or pawn move are never compared.
+        bool isRepetitionDraw(const Position& position, int distance) const;
+
+        // Whether the side to move has a piece move that repeats an earlier
+        // position, by the same rules as isRepetitionDraw
+        bool hasUpcomingRepetition(const Position& position, int distance) const;
+
+        void reserve(size_t size) { m_keys.reserve(size); }
+        size_t size() const { return m_keys.size(); }
+
+    private:
+        std::vector<Zobrist> m_keys{};
+
+        int firstReversible(const Position& position) const;
+        bool repeatsEarlier(int index, int first) const;
+    };
+}
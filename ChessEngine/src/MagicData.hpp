@@ -8,139 +8,145 @@ namespace Chess {
         Bitboard mask;
         uint64_t magic;
         uint8_t shifts;
+        // start of this square's attacks in the shared slider table
+        uint32_t offset;
     };
 
     namespace MagicData {
+        // rook and bishop attacks share one table, each square taking
+        // exactly 1 << (64 - shifts) entries
+        constexpr size_t sliderTableSize = 107648;
+
         constexpr Array<MagicEntry, 64> rookMagics{ {
-            {Bitboard{282578800148862ULL}, 36028969090285696ULL, 52},
-            {Bitboard{565157600297596ULL}, 630504240426561536ULL, 53},
-            {Bitboard{1130315200595066ULL}, 2413964585314812288ULL, 53},
-            {Bitboard{2260630401190006ULL}, 36037599555485708ULL, 53},
-            {Bitboard{4521260802379886ULL}, 1297071946447585284ULL, 53},
-            {Bitboard{9042521604759646ULL}, 4755802652095414280ULL, 53},
-            {Bitboard{18085043209519166ULL}, 72094977714553088ULL, 53},
-            {Bitboard{36170086419038334ULL}, 36029896736252032ULL, 52},
-            {Bitboard{282578800180736ULL}, 2392548041834496ULL, 53},
-            {Bitboard{565157600328704ULL}, 1152991942074736640ULL, 54},
-            {Bitboard{1130315200625152ULL}, 1164743737104932880ULL, 54},
-            {Bitboard{2260630401218048ULL}, 9288742990315552ULL, 54},
-            {Bitboard{4521260802403840ULL}, 140840601911424ULL, 54},
-            {Bitboard{9042521604775424ULL}, 586030988628361728ULL, 54},
-            {Bitboard{18085043209518592ULL}, 5764748440911413376ULL, 54},
-            {Bitboard{36170086419037696ULL}, 577023706585453708ULL, 53},
-            {Bitboard{282578808340736ULL}, 106102880616448ULL, 53},
-            {Bitboard{565157608292864ULL}, 4616192091958018114ULL, 54},
-            {Bitboard{1130315208328192ULL}, 9304442328246714448ULL, 54},
-            {Bitboard{2260630408398848ULL}, 1153204079363629452ULL, 54},
-            {Bitboard{4521260808540160ULL}, 2323862905566533633ULL, 54},
-            {Bitboard{9042521608822784ULL}, 4626464005098046465ULL, 54},
-            {Bitboard{18085043209388032ULL}, 9263979201239846913ULL, 54},
-            {Bitboard{36170086418907136ULL}, 1409574485639428ULL, 53},
-            {Bitboard{282580897300736ULL}, 18084769403666432ULL, 53},
-            {Bitboard{565159647117824ULL}, 5332297148547485696ULL, 54},
-            {Bitboard{1130317180306432ULL}, 292734113755431936ULL, 54},
-            {Bitboard{2260632246683648ULL}, 2342311617326743680ULL, 54},
-            {Bitboard{4521262379438080ULL}, 4917939595624317056ULL, 54},
-            {Bitboard{9042522644946944ULL}, 4972224679424033280ULL, 54},
-            {Bitboard{18085043175964672ULL}, 26405459984642ULL, 54},
-            {Bitboard{36170086385483776ULL}, 2305865008036201601ULL, 53},
-            {Bitboard{283115671060736ULL}, 9511743425381142560ULL, 53},
-            {Bitboard{565681586307584ULL}, 1441750083807739971ULL, 54},
-            {Bitboard{1130822006735872ULL}, 145944845251256832ULL, 54},
-            {Bitboard{2261102847592448ULL}, 3458914193464377360ULL, 54},
-            {Bitboard{4521664529305600ULL}, 54047604320765952ULL, 54},
-            {Bitboard{9042787892731904ULL}, 72198357304476672ULL, 54},
-            {Bitboard{18085034619584512ULL}, 1275502274838786ULL, 54},
-            {Bitboard{36170077829103616ULL}, 39722038592069ULL, 53},
-            {Bitboard{420017753620736ULL}, 5260416025085739042ULL, 53},
-            {Bitboard{699298018886144ULL}, 2305948631087300608ULL, 54},
-            {Bitboard{1260057572672512ULL}, 288810918828081280ULL, 54},
-            {Bitboard{2381576680245248ULL}, 579275653069799440ULL, 54},
-            {Bitboard{4624614895390720ULL}, 7277825793990885504ULL, 54},
-            {Bitboard{9110691325681664ULL}, 144678206884151300ULL, 54},
-            {Bitboard{18082844186263552ULL}, 2310349427279396865ULL, 54},
-            {Bitboard{36167887395782656ULL}, 9223653513983229962ULL, 53},
-            {Bitboard{35466950888980736ULL}, 585542875115489536ULL, 53},
-            {Bitboard{34905104758997504ULL}, 2603718706989184ULL, 54},
-            {Bitboard{34344362452452352ULL}, 9641213738190336ULL, 54},
-            {Bitboard{33222877839362048ULL}, 2305851805575184512ULL, 54},
-            {Bitboard{30979908613181440ULL}, 1229623714935484418ULL, 54},
-            {Bitboard{26493970160820224ULL}, 281492156713216ULL, 54},
-            {Bitboard{17522093256097792ULL}, 9223653537601556736ULL, 54},
-            {Bitboard{35607136465616896ULL}, 4629700705027105280ULL, 53},
-            {Bitboard{9079539427579068672ULL}, 72198473278177798ULL, 52},
-            {Bitboard{8935706818303361536ULL}, 9043491736929298ULL, 53},
-            {Bitboard{8792156787827803136ULL}, 175922012815425ULL, 53},
-            {Bitboard{8505056726876686336ULL}, 72062060814467113ULL, 53},
-            {Bitboard{7930856604974452736ULL}, 564187038502914ULL, 53},
-            {Bitboard{6782456361169985536ULL}, 281485378594817ULL, 53},
-            {Bitboard{4485655873561051136ULL}, 3171134539888101380ULL, 53},
-            {Bitboard{9115426935197958144ULL}, 72062018429452930ULL, 52} }};
+            {Bitboard{282578800148862ULL}, 36046527717736448ULL, 52, 0},
+            {Bitboard{565157600297596ULL}, 2323858301078470722ULL, 53, 4096},
+            {Bitboard{1130315200595066ULL}, 4647750001983262720ULL, 53, 6144},
+            {Bitboard{2260630401190006ULL}, 9871894987417853992ULL, 53, 8192},
+            {Bitboard{4521260802379886ULL}, 36033195199725570ULL, 53, 10240},
+            {Bitboard{9042521604759646ULL}, 72077402427638016ULL, 53, 12288},
+            {Bitboard{18085043209519166ULL}, 36039792177189120ULL, 53, 14336},
+            {Bitboard{36170086419038334ULL}, 180153091104964864ULL, 52, 16384},
+            {Bitboard{282578800180736ULL}, 576601492077674528ULL, 53, 20480},
+            {Bitboard{565157600328704ULL}, 308707749496095808ULL, 54, 22528},
+            {Bitboard{1130315200625152ULL}, 586735001278615552ULL, 54, 23552},
+            {Bitboard{2260630401218048ULL}, 13835621144021041176ULL, 54, 24576},
+            {Bitboard{4521260802403840ULL}, 3237512122237952ULL, 54, 25600},
+            {Bitboard{9042521604775424ULL}, 4620834505094075392ULL, 54, 26624},
+            {Bitboard{18085043209518592ULL}, 288934613936505344ULL, 54, 27648},
+            {Bitboard{36170086419037696ULL}, 74872422255329538ULL, 53, 28672},
+            {Bitboard{282578808340736ULL}, 40132283482120ULL, 53, 30720},
+            {Bitboard{565157608292864ULL}, 5048676470601031680ULL, 54, 32768},
+            {Bitboard{1130315208328192ULL}, 89060978770176ULL, 54, 33792},
+            {Bitboard{2260630408398848ULL}, 45740233739765761ULL, 54, 34816},
+            {Bitboard{4521260808540160ULL}, 4612812468224294917ULL, 54, 35840},
+            {Bitboard{9042521608822784ULL}, 8800929058820ULL, 54, 36864},
+            {Bitboard{18085043209388032ULL}, 50124536363942472ULL, 54, 37888},
+            {Bitboard{36170086418907136ULL}, 1009934415801123841ULL, 53, 38912},
+            {Bitboard{282580897300736ULL}, 594475290399382080ULL, 53, 40960},
+            {Bitboard{565159647117824ULL}, 1191273028535845120ULL, 54, 43008},
+            {Bitboard{1130317180306432ULL}, 1731669243251920896ULL, 54, 44032},
+            {Bitboard{2260632246683648ULL}, 176097959346433ULL, 54, 45056},
+            {Bitboard{4521262379438080ULL}, 290281807413376ULL, 54, 46080},
+            {Bitboard{9042522644946944ULL}, 9223374238033904640ULL, 54, 47104},
+            {Bitboard{18085043175964672ULL}, 16140927504318795846ULL, 54, 48128},
+            {Bitboard{36170086385483776ULL}, 73465544447688812ULL, 53, 49152},
+            {Bitboard{283115671060736ULL}, 1153594680710004864ULL, 53, 51200},
+            {Bitboard{565681586307584ULL}, 4688248449047461952ULL, 54, 53248},
+            {Bitboard{1130822006735872ULL}, 4611703612769312778ULL, 54, 54272},
+            {Bitboard{2261102847592448ULL}, 4614079689609203712ULL, 54, 55296},
+            {Bitboard{4521664529305600ULL}, 443604580484284424ULL, 54, 56320},
+            {Bitboard{9042787892731904ULL}, 9223657912033886720ULL, 54, 57344},
+            {Bitboard{18085034619584512ULL}, 1153211784333627473ULL, 54, 58368},
+            {Bitboard{36170077829103616ULL}, 180251473127407884ULL, 53, 59392},
+            {Bitboard{420017753620736ULL}, 594616026813988864ULL, 53, 61440},
+            {Bitboard{699298018886144ULL}, 4760305081545408528ULL, 54, 63488},
+            {Bitboard{1260057572672512ULL}, 616993733602344977ULL, 54, 64512},
+            {Bitboard{2381576680245248ULL}, 9368050467484073992ULL, 54, 65536},
+            {Bitboard{4624614895390720ULL}, 82191247384543237ULL, 54, 66560},
+            {Bitboard{9110691325681664ULL}, 1126449830461444ULL, 54, 67584},
+            {Bitboard{18082844186263552ULL}, 17598662311944ULL, 54, 68608},
+            {Bitboard{36167887395782656ULL}, 37159097149554689ULL, 53, 69632},
+            {Bitboard{35466950888980736ULL}, 37225169294459008ULL, 53, 71680},
+            {Bitboard{34905104758997504ULL}, 12254294723543435328ULL, 54, 73728},
+            {Bitboard{34344362452452352ULL}, 1156334388967933056ULL, 54, 74752},
+            {Bitboard{33222877839362048ULL}, 2260741953438208ULL, 54, 75776},
+            {Bitboard{30979908613181440ULL}, 6755674654638144ULL, 54, 76800},
+            {Bitboard{26493970160820224ULL}, 1153484523684823552ULL, 54, 77824},
+            {Bitboard{17522093256097792ULL}, 562988688345600ULL, 54, 78848},
+            {Bitboard{35607136465616896ULL}, 397454491303281152ULL, 53, 79872},
+            {Bitboard{9079539427579068672ULL}, 4611705259885109507ULL, 52, 81920},
+            {Bitboard{8935706818303361536ULL}, 2918649789119725585ULL, 53, 86016},
+            {Bitboard{8792156787827803136ULL}, 5769182591724815657ULL, 53, 88064},
+            {Bitboard{8505056726876686336ULL}, 36037731893118209ULL, 53, 90112},
+            {Bitboard{7930856604974452736ULL}, 563104975953922ULL, 53, 92160},
+            {Bitboard{6782456361169985536ULL}, 13836465464592597573ULL, 53, 94208},
+            {Bitboard{4485655873561051136ULL}, 4611687150957101604ULL, 53, 96256},
+            {Bitboard{9115426935197958144ULL}, 291058874176380998ULL, 52, 98304} }};
 
         constexpr Array<MagicEntry, 64> bishopMagics{ {
-            {Bitboard{18049651735527936ULL}, 594492751622717456ULL, 58},
-            {Bitboard{70506452091904ULL}, 3533082738133311512ULL, 59},
-            {Bitboard{275415828992ULL}, 11267796344784896ULL, 59},
-            {Bitboard{1075975168ULL}, 4802950266355904ULL, 59},
-            {Bitboard{38021120ULL}, 1154346746889900039ULL, 59},
-            {Bitboard{8657588224ULL}, 848832657426432ULL, 59},
-            {Bitboard{2216338399232ULL}, 2885685877039169664ULL, 59},
-            {Bitboard{567382630219776ULL}, 1226140895923937288ULL, 58},
-            {Bitboard{9024825867763712ULL}, 1297249327992012864ULL, 59},
-            {Bitboard{18049651735527424ULL}, 725115360369983552ULL, 59},
-            {Bitboard{70506452221952ULL}, 27320996344176672ULL, 59},
-            {Bitboard{275449643008ULL}, 144295559800307712ULL, 59},
-            {Bitboard{9733406720ULL}, 651071421207830532ULL, 59},
-            {Bitboard{2216342585344ULL}, 774762076983463936ULL, 59},
-            {Bitboard{567382630203392ULL}, 9223373147240139144ULL, 59},
-            {Bitboard{1134765260406784ULL}, 139625238528ULL, 59},
-            {Bitboard{4512412933816832ULL}, 40681964865323712ULL, 59},
-            {Bitboard{9024825867633664ULL}, 4613960927329653761ULL, 59},
-            {Bitboard{18049651768822272ULL}, 1785677303804856328ULL, 57},
-            {Bitboard{70515108615168ULL}, 577586687647951202ULL, 57},
-            {Bitboard{2491752130560ULL}, 140754745820456ULL, 57},
-            {Bitboard{567383701868544ULL}, 81768498183537984ULL, 57},
-            {Bitboard{1134765256220672ULL}, 36591894628933632ULL, 59},
-            {Bitboard{2269530512441344ULL}, 16140936257508280480ULL, 59},
-            {Bitboard{2256206450263040ULL}, 4039799236911699208ULL, 59},
-            {Bitboard{4512412900526080ULL}, 2254012261999144ULL, 59},
-            {Bitboard{9024834391117824ULL}, 19142566494872577ULL, 57},
-            {Bitboard{18051867805491712ULL}, 181296275495388176ULL, 55},
-            {Bitboard{637888545440768ULL}, 145808436150438420ULL, 55},
-            {Bitboard{1135039602493440ULL}, 612561018820755968ULL, 57},
-            {Bitboard{2269529440784384ULL}, 1175725376321356040ULL, 59},
-            {Bitboard{4539058881568768ULL}, 11683463883066197061ULL, 59},
-            {Bitboard{1128098963916800ULL}, 6764470412264448ULL, 59},
-            {Bitboard{2256197927833600ULL}, 4611844691968147984ULL, 59},
-            {Bitboard{4514594912477184ULL}, 307370966628433952ULL, 57},
-            {Bitboard{9592139778506752ULL}, 580968754407276800ULL, 55},
-            {Bitboard{19184279556981248ULL}, 9529619019129325576ULL, 55},
-            {Bitboard{2339762086609920ULL}, 432644670045037568ULL, 57},
-            {Bitboard{4538784537380864ULL}, 42821580929368320ULL, 59},
-            {Bitboard{9077569074761728ULL}, 10383051295115739264ULL, 59},
-            {Bitboard{562958610993152ULL}, 3749251233995563012ULL, 59},
-            {Bitboard{1125917221986304ULL}, 11541601083893813248ULL, 59},
-            {Bitboard{2814792987328512ULL}, 477454129493446656ULL, 57},
-            {Bitboard{5629586008178688ULL}, 576744434926879776ULL, 57},
-            {Bitboard{11259172008099840ULL}, 37437417476588576ULL, 57},
-            {Bitboard{22518341868716544ULL}, 1297898778543523905ULL, 57},
-            {Bitboard{9007336962655232ULL}, 4521337847554208ULL, 59},
-            {Bitboard{18014673925310464ULL}, 2871941560535584ULL, 59},
-            {Bitboard{2216338399232ULL}, 10278304524272648ULL, 59},
-            {Bitboard{4432676798464ULL}, 1225053891265036322ULL, 59},
-            {Bitboard{11064376819712ULL}, 18596046614560768ULL, 59},
-            {Bitboard{22137335185408ULL}, 1152921507861757976ULL, 59},
-            {Bitboard{44272556441600ULL}, 1729663800707256320ULL, 59},
-            {Bitboard{87995357200384ULL}, 2887431953814945794ULL, 59},
-            {Bitboard{35253226045952ULL}, 1190392912492462600ULL, 59},
-            {Bitboard{70506452091904ULL}, 1130579341149256ULL, 59},
-            {Bitboard{567382630219776ULL}, 468413960912372289ULL, 58},
-            {Bitboard{1134765260406784ULL}, 2305843841435965488ULL, 59},
-            {Bitboard{2832480465846272ULL}, 3458764694494488576ULL, 59},
-            {Bitboard{5667157807464448ULL}, 234187223575070736ULL, 59},
-            {Bitboard{11333774449049600ULL}, 4503737402934272ULL, 59},
-            {Bitboard{22526811443298304ULL}, 72136918326051076ULL, 59},
-            {Bitboard{9024825867763712ULL}, 469518472087404616ULL, 59},
-            {Bitboard{18049651735527936ULL}, 942523580988784900ULL, 58} }};
+            {Bitboard{18049651735527936ULL}, 577028134706349184ULL, 58, 102400},
+            {Bitboard{70506452091904ULL}, 11610280943218262016ULL, 59, 102464},
+            {Bitboard{275415828992ULL}, 310752800271262256ULL, 59, 102496},
+            {Bitboard{1075975168ULL}, 281484060633761056ULL, 59, 102528},
+            {Bitboard{38021120ULL}, 4468996076594003970ULL, 59, 102560},
+            {Bitboard{8657588224ULL}, 1153204114528673808ULL, 59, 102592},
+            {Bitboard{2216338399232ULL}, 2307114113509400648ULL, 59, 102624},
+            {Bitboard{567382630219776ULL}, 11529251331162249280ULL, 58, 102656},
+            {Bitboard{9024825867763712ULL}, 9250428905499689994ULL, 59, 102720},
+            {Bitboard{18049651735527424ULL}, 1170971097187353632ULL, 59, 102752},
+            {Bitboard{70506452221952ULL}, 2261010439241792ULL, 59, 102784},
+            {Bitboard{275449643008ULL}, 8935698334720ULL, 59, 102816},
+            {Bitboard{9733406720ULL}, 2323938780443067649ULL, 59, 102848},
+            {Bitboard{2216342585344ULL}, 36171738431619361ULL, 59, 102880},
+            {Bitboard{567382630203392ULL}, 676666960976825392ULL, 59, 102912},
+            {Bitboard{1134765260406784ULL}, 6124897702381880452ULL, 59, 102944},
+            {Bitboard{4512412933816832ULL}, 1242993634662678704ULL, 59, 102976},
+            {Bitboard{9024825867633664ULL}, 293297613598425344ULL, 59, 103008},
+            {Bitboard{18049651768822272ULL}, 571784835498114ULL, 57, 103040},
+            {Bitboard{70515108615168ULL}, 316676595810568ULL, 57, 103168},
+            {Bitboard{2491752130560ULL}, 432915746924855832ULL, 57, 103296},
+            {Bitboard{567383701868544ULL}, 1154328914655588352ULL, 57, 103424},
+            {Bitboard{1134765256220672ULL}, 1441297020597833732ULL, 59, 103552},
+            {Bitboard{2269530512441344ULL}, 9227957004838929424ULL, 59, 103584},
+            {Bitboard{2256206450263040ULL}, 4612565632293285936ULL, 59, 103616},
+            {Bitboard{4512412900526080ULL}, 4505808049276164ULL, 59, 103648},
+            {Bitboard{9024834391117824ULL}, 149534156521728ULL, 57, 103680},
+            {Bitboard{18051867805491712ULL}, 1461426877330751490ULL, 55, 103808},
+            {Bitboard{637888545440768ULL}, 45038196383305728ULL, 55, 104320},
+            {Bitboard{1135039602493440ULL}, 1171297642542596354ULL, 57, 104832},
+            {Bitboard{2269529440784384ULL}, 74601950398418944ULL, 59, 104960},
+            {Bitboard{4539058881568768ULL}, 1137033003729932ULL, 59, 104992},
+            {Bitboard{1128098963916800ULL}, 4576513140199424ULL, 59, 105024},
+            {Bitboard{2256197927833600ULL}, 576751033844270146ULL, 59, 105056},
+            {Bitboard{4514594912477184ULL}, 4613376006457132224ULL, 57, 105088},
+            {Bitboard{9592139778506752ULL}, 1152924259828892160ULL, 55, 105216},
+            {Bitboard{19184279556981248ULL}, 4505807245025288ULL, 55, 105728},
+            {Bitboard{2339762086609920ULL}, 297810717321596928ULL, 57, 106240},
+            {Bitboard{4538784537380864ULL}, 331085495549563136ULL, 59, 106368},
+            {Bitboard{9077569074761728ULL}, 144682571006003712ULL, 59, 106400},
+            {Bitboard{562958610993152ULL}, 5634181216485456ULL, 59, 106432},
+            {Bitboard{1125917221986304ULL}, 1443545038817595392ULL, 59, 106464},
+            {Bitboard{2814792987328512ULL}, 146947805712484360ULL, 57, 106496},
+            {Bitboard{5629586008178688ULL}, 77336083100092416ULL, 57, 106624},
+            {Bitboard{11259172008099840ULL}, 36038838954492932ULL, 57, 106752},
+            {Bitboard{22518341868716544ULL}, 9227910825485275200ULL, 57, 106880},
+            {Bitboard{9007336962655232ULL}, 5673568381700866ULL, 59, 107008},
+            {Bitboard{18014673925310464ULL}, 24816531493900801ULL, 59, 107040},
+            {Bitboard{2216338399232ULL}, 848866463515904ULL, 59, 107072},
+            {Bitboard{4432676798464ULL}, 46282601660449ULL, 59, 107104},
+            {Bitboard{11064376819712ULL}, 6917531510158393348ULL, 59, 107136},
+            {Bitboard{22137335185408ULL}, 2574275655630994ULL, 59, 107168},
+            {Bitboard{44272556441600ULL}, 9369176899466692128ULL, 59, 107200},
+            {Bitboard{87995357200384ULL}, 585679067525742592ULL, 59, 107232},
+            {Bitboard{35253226045952ULL}, 578747749577592866ULL, 59, 107264},
+            {Bitboard{70506452091904ULL}, 5682852159094784ULL, 59, 107296},
+            {Bitboard{567382630219776ULL}, 599380000522372ULL, 58, 107328},
+            {Bitboard{1134765260406784ULL}, 9223940486547448136ULL, 59, 107392},
+            {Bitboard{2832480465846272ULL}, 283727691778064ULL, 59, 107424},
+            {Bitboard{5667157807464448ULL}, 4611686018700153352ULL, 59, 107456},
+            {Bitboard{11333774449049600ULL}, 36028804535485188ULL, 59, 107488},
+            {Bitboard{22526811443298304ULL}, 14276483661443629332ULL, 59, 107520},
+            {Bitboard{9024825867763712ULL}, 1130504381333769ULL, 59, 107552},
+            {Bitboard{18049651735527936ULL}, 1754163084341805189ULL, 58, 107584} }};
     } 
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
-
+// Regenerates MagicData.hpp. Not part of the engine build, compile it on
+// its own against the engine library and run it from the repository root:
+//   g++ -std=c++20 -DGEN_MAGIC -I ChessEngine/src -o MagicGenerator
+//       ChessEngine/src/MagicGenerator.cpp build/lib/libChessEngine.a
+//   ./MagicGenerator [output path]
+// The search is seeded with a constant, so rerunning it reproduces the
+// committed header exactly.
 #ifdef GEN_MAGIC
 
 #include <array>
 #include <fstream>
+#include <iostream>
 #include <random>
 #include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -17,8 +25,11 @@ namespace Chess {
         Bitboard mask;
         uint64_t magic;
         uint8_t shifts;
+        uint32_t offset;
     };
 
+    constexpr uint64_t k_seed = 0x9E3779B97F4A7C15ULL;
+
     Bitboard getMagicMask(uint8_t square, bool rook) {
         Bitboard mask{};
 
@@ -38,18 +49,17 @@ namespace Chess {
         return mask;
     }
 
-    MagicEntry genMagic(uint8_t square, bool rook) {
+    // Raw engine output rather than a distribution, whose results differ
+    // between standard libraries
+    MagicEntry genMagic(uint8_t square, bool rook, std::mt19937_64& rng) {
         Bitboard mask = getMagicMask(square, rook);
         uint8_t shifts = 64 - mask.numBits();
 
-        static std::mt19937 mt{ std::random_device{}() };
-        static std::uniform_int_distribution<uint64_t> distrib(0, UINT64_MAX);
-
         const std::vector<Bitboard> subsets{ Utils::getSubsets(mask) };
 
         while (true) {
             std::vector<int> visited(1 << (64 - shifts));
-            const uint64_t candidate = distrib(mt) & distrib(mt) & distrib(mt);
+            const uint64_t candidate = rng() & rng() & rng();
             bool success = true;
 
             for (Bitboard blockers : subsets) {
@@ -61,55 +71,80 @@ namespace Chess {
                 visited[index] = 1;
             }
             if (success) {
-                return MagicEntry{ mask, candidate, shifts };
+                return MagicEntry{ mask, candidate, shifts, 0 };
             }
         }
     }
 
     std::ostream& operator<<(std::ostream& out, const MagicEntry& entry) {
-        out << "{Bitboard {" << entry.mask.get() << "ULL}, " << entry.magic << "ULL, "
-            << static_cast<int>(entry.shifts) << "}";
+        out << "{Bitboard{" << entry.mask.get() << "ULL}, " << entry.magic << "ULL, "
+            << static_cast<int>(entry.shifts) << ", " << entry.offset << "}";
         return out;
     }
 
     std::ostream& operator<<(std::ostream& out, const Array<MagicEntry, 64>& arr) {
-        out << "{{";
+        out << "{ {\n";
         for (uint8_t i = 0; i < 63; i++) {
-            out << arr[i] << ", ";
+            out << "            " << arr[i] << ",\n";
         }
-        out << arr[63] << "}}";
+        out << "            " << arr[63] << " }}";
         return out;
     }
 
-    void outputToFile(std::string_view file) {
-        std::ofstream outf{ file.data() };
+    void outputToFile(const std::string& file) {
+        std::ofstream outf{ file };
         Array<MagicEntry, 64> rookMagics;
         Array<MagicEntry, 64> bishopMagics;
 
         if (!outf) {
-            throw std::runtime_error{ "Failed to open file" };
+            throw std::runtime_error{ "Failed to open " + file };
         }
 
+        std::mt19937_64 rng{ k_seed };
         for (uint8_t square = 0; square < 64; square++) {
-            rookMagics[square] = genMagic(square, true);
-            bishopMagics[square] = genMagic(square, false);
+            rookMagics[square] = genMagic(square, true, rng);
+            bishopMagics[square] = genMagic(square, false, rng);
+        }
+
+        // pack every square's attacks back to back, rooks then bishops
+        uint32_t offset = 0;
+        for (Array<MagicEntry, 64>* magics : { &rookMagics, &bishopMagics }) {
+            for (MagicEntry& entry : *magics) {
+                entry.offset = offset;
+                offset += 1U << (64 - entry.shifts);
+            }
         }
 
         outf << "#pragma once\n\n"
-            "#include \"Bitboard.hpp\"\n\n"
+            "#include \"Bitboard.hpp\"\n"
+            "#include \"DataStructures.hpp\"\n\n"
             "namespace Chess {\n"
-            "  struct MagicEntry {\n"
-            "    Bitboard mask;\n"
-            "    uint64_t magic;\n"
-            "    uint8_t shifts;\n"
-            "  };\n\n"
-            "  namespace MagicData {\n";
-        outf << "    constexpr Array<MagicEntry, 64> rookMagics " << rookMagics << ";\n\n";
-        outf << "    constexpr Array<MagicEntry, 64> bishopMagics " << bishopMagics << ";\n";
-        outf << "  }\n";
-        outf << "}"
+            "    struct MagicEntry {\n"
+            "        Bitboard mask;\n"
+            "        uint64_t magic;\n"
+            "        uint8_t shifts;\n"
+            "        // start of this square's attacks in the shared slider table\n"
+            "        uint32_t offset;\n"
+            "    };\n\n"
+            "    namespace MagicData {\n"
+            "        // rook and bishop attacks share one table, each square taking\n"
+            "        // exactly 1 << (64 - shifts) entries\n";
+        outf << "        constexpr size_t sliderTableSize = " << offset << ";\n\n";
+        outf << "        constexpr Array<MagicEntry, 64> rookMagics" << rookMagics << ";\n\n";
+        outf << "        constexpr Array<MagicEntry, 64> bishopMagics" << bishopMagics << ";\n";
+        outf << "    } \n";
+        outf << "}";
     }
+}
 
-    int main() { outputToFile("src/game/MagicData.hpp"); }
+int main(int argc, char** argv) {
+    try {
+        Chess::outputToFile(argc > 1 ? argv[1] : "ChessEngine/src/MagicData.hpp");
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
 }
-#endif
\ No newline at end of file
+#endif
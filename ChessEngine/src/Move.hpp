@@ -6,17 +6,69 @@
 #include "DataStructures.hpp"
 
 namespace Chess {
-    struct Move {
-        uint8_t start{};
-        uint8_t target{};
-        PieceType promotion = PieceType::Null;
-
-        bool operator==(Move other) const {
-            return other.start == start && other.target == target &&
-                other.promotion == promotion;
+    // Set by the move generator, so making and ordering a move never has to
+    // work out what kind of move it is from the board. Bit 2 marks captures,
+    // bit 3 promotions, and the low two bits of a promotion pick the piece.
+    enum class MoveFlag : uint8_t {
+        Quiet = 0,
+        DoublePush = 1,
+        KingCastle = 2,
+        QueenCastle = 3,
+        Capture = 4,
+        EnPassant = 5,
+        BishopPromotion = 8,
+        KnightPromotion = 9,
+        RookPromotion = 10,
+        QueenPromotion = 11,
+        BishopPromotionCapture = 12,
+        KnightPromotionCapture = 13,
+        RookPromotionCapture = 14,
+        QueenPromotionCapture = 15
+    };
+
+    constexpr MoveFlag promotionFlag(PieceType promotion, bool capture) {
+        return static_cast<MoveFlag>(0b1000 | (capture ? 0b100 : 0) |
+            (static_cast<uint8_t>(promotion) - static_cast<uint8_t>(PieceType::Bishop)));
+    }
+
+    // Packed as start | target << 6 | flag << 12. The default move, a8 to a8,
+    // stands for no move.
+    class Move {
+    public:
+        constexpr Move() = default;
+        constexpr Move(uint8_t start, uint8_t target, MoveFlag flag = MoveFlag::Quiet)
+            : m_data(static_cast<uint16_t>(start | (target << 6) |
+                (static_cast<uint8_t>(flag) << 12))) {}
+
+        static constexpr Move fromRaw(uint16_t raw) {
+            Move move{};
+            move.m_data = raw;
+            return move;
         }
+
+        constexpr uint8_t start() const { return m_data & 0x3F; }
+        constexpr uint8_t target() const { return (m_data >> 6) & 0x3F; }
+        constexpr MoveFlag flag() const { return static_cast<MoveFlag>(m_data >> 12); }
+        constexpr uint16_t raw() const { return m_data; }
+
+        // includes en passant, where the target square is empty
+        constexpr bool isCapture() const { return m_data & (0b100 << 12); }
+        constexpr bool isPromotion() const { return m_data & (0b1000 << 12); }
+
+        // piece the pawn becomes, PieceType::Null for everything else
+        constexpr PieceType promotion() const {
+            return isPromotion() ? static_cast<PieceType>(((m_data >> 12) & 0b11) +
+                static_cast<uint8_t>(PieceType::Bishop)) : PieceType::Null;
+        }
+
+        constexpr bool operator==(const Move& other) const = default;
+
+    private:
+        uint16_t m_data{};
     };
 
+    static_assert(sizeof(Move) == 2);
+
     class MoveList {
     public:
         Move& operator[](uint8_t index) { return m_moves[index]; }
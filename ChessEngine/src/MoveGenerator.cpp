@@ -13,393 +13,796 @@
 using namespace Chess;
 
 namespace {
+    // Everything below is instantiated once per side to move, so pawn
+    // directions, ranks and castling squares fold into constants.
+    template <PieceColor Us>
+    constexpr PieceColor Them = oppositeColor(Us);
+
+    template <PieceColor Us>
+    constexpr Bitboard forward(Bitboard board) {
+        if constexpr (Us == PieceColor::White) return board.north();
+        else return board.south();
+    }
+
+    template <PieceColor Us>
+    constexpr Bitboard forwardEast(Bitboard board) {
+        if constexpr (Us == PieceColor::White) return board.northEast();
+        else return board.southEast();
+    }
+
+    template <PieceColor Us>
+    constexpr Bitboard forwardWest(Bitboard board) {
+        if constexpr (Us == PieceColor::White) return board.northWest();
+        else return board.southWest();
+    }
+
+    template <PieceColor Us>
+    constexpr Bitboard promotionRank =
+        Us == PieceColor::White ? Bitboard::mask8() : Bitboard::mask1();
+
+    // rank a pawn lands on after a single push from its starting square
+    template <PieceColor Us>
+    constexpr Bitboard doublePushRank =
+        Us == PieceColor::White ? Bitboard::mask3() : Bitboard::mask6();
+
+    // target - start of a single pawn push
+    template <PieceColor Us>
+    constexpr int pawnOffset = Us == PieceColor::White ? -8 : 8;
+
+    template <PieceColor Us>
+    constexpr Bitboard kingsideCastleMask =
+        Us == PieceColor::White ? Bitboard{ 0b11ULL << 61 } : Bitboard{ 0b11ULL << 5 };
+
+    template <PieceColor Us>
+    constexpr Bitboard queensideCastleFriendlyMask =
+        Us == PieceColor::White ? Bitboard{ 0b111ULL << 57 } : Bitboard{ 0b111ULL << 1 };
+
+    template <PieceColor Us>
+    constexpr Bitboard queensideCastleDangerMask =
+        Us == PieceColor::White ? Bitboard{ 0b11ULL << 58 } : Bitboard{ 0b11ULL << 2 };
+
+    template <PieceColor Us>
+    Bitboard orthogonal(const Position& position) {
+        return position.getBitboard(PieceType::Rook, Us) |
+            position.getBitboard(PieceType::Queen, Us);
+    }
+
+    template <PieceColor Us>
+    Bitboard diagonal(const Position& position) {
+        return position.getBitboard(PieceType::Bishop, Us) |
+            position.getBitboard(PieceType::Queen, Us);
+    }
+
+    template <PieceColor Us>
+    uint8_t kingSquare(const Position& position) {
+        return position.getBitboard(PieceType::King, Us).getLSBIndex();
+    }
+
+    template <PieceColor Us>
     Bitboard getDangerSquares(const Position& position) {
         Bitboard dangers{};
         const Bitboard occupied =
-            position.getOccupied() &
-            ~position.getBitboard(PieceType::King, position.getTurn());
+            position.getOccupied() & ~position.getBitboard(PieceType::King, Us);
 
-        Bitboard orthogonal = position.getOpponentOrthogonal();
-        while (orthogonal) {
-            const uint8_t square = orthogonal.popLSB();
+        Bitboard orthogonals = orthogonal<Them<Us>>(position);
+        while (orthogonals) {
+            const uint8_t square = orthogonals.popLSB();
             dangers |= PregeneratedMoves::getRookMoves(square, occupied);
         }
 
-        Bitboard diagonal = position.getOpponentDiagonal();
-        while (diagonal) {
-            const uint8_t square = diagonal.popLSB();
+        Bitboard diagonals = diagonal<Them<Us>>(position);
+        while (diagonals) {
+            const uint8_t square = diagonals.popLSB();
             dangers |= PregeneratedMoves::getBishopMoves(square, occupied);
         }
 
-        Bitboard knights = position.getOpponentKnights();
+        Bitboard knights = position.getBitboard(PieceType::Knight, Them<Us>);
         while (knights) {
             const uint8_t square = knights.popLSB();
             dangers |= PregeneratedMoves::getKnightMoves(square);
         }
 
-        const Bitboard pawns = position.getOpponentPawns();
-        if (position.getTurn() == PieceColor::White) {
-            dangers |= pawns.southEast();
-            dangers |= pawns.southWest();
-        }
-        else {
-            dangers |= pawns.northEast();
-            dangers |= pawns.northWest();
-        }
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Them<Us>);
+        dangers |= forwardEast<Them<Us>>(pawns);
+        dangers |= forwardWest<Them<Us>>(pawns);
 
-        dangers |= PregeneratedMoves::getKingMoves(position.getOpponentKingSquare());
+        dangers |= PregeneratedMoves::getKingMoves(kingSquare<Them<Us>>(position));
 
         return dangers;
     }
 
+    template <PieceColor Us>
     Bitboard getAttackers(const Position& position) {
-        const uint8_t kingSquare = position.getFriendlyKingSquare();
+        const uint8_t king = kingSquare<Us>(position);
         const Bitboard occupied = position.getOccupied();
 
         Bitboard attackers{};
 
-        const Bitboard knights = position.getOpponentKnights();
-        attackers |= PregeneratedMoves::getKnightMoves(kingSquare) & knights;
+        const Bitboard knights = position.getBitboard(PieceType::Knight, Them<Us>);
+        attackers |= PregeneratedMoves::getKnightMoves(king) & knights;
 
-        const Bitboard orthogonal = position.getOpponentOrthogonal();
-        attackers |=
-            PregeneratedMoves::getRookMoves(kingSquare, occupied) & orthogonal;
+        attackers |= PregeneratedMoves::getRookMoves(king, occupied) &
+            orthogonal<Them<Us>>(position);
 
-        const Bitboard diagonal = position.getOpponentDiagonal();
-        attackers |=
-            PregeneratedMoves::getBishopMoves(kingSquare, occupied) & diagonal;
+        attackers |= PregeneratedMoves::getBishopMoves(king, occupied) &
+            diagonal<Them<Us>>(position);
 
-        const Bitboard pawns = position.getOpponentPawns();
-        const Bitboard king = Bitboard::fromSquare(kingSquare);
-        if (position.getTurn() == PieceColor::White) {
-            attackers |= king.northEast() & pawns;
-            attackers |= king.northWest() & pawns;
-        }
-        else {
-            attackers |= king.southEast() & pawns;
-            attackers |= king.southWest() & pawns;
-        }
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Them<Us>);
+        const Bitboard kingBoard = Bitboard::fromSquare(king);
+        attackers |= forwardEast<Us>(kingBoard) & pawns;
+        attackers |= forwardWest<Us>(kingBoard) & pawns;
 
         return attackers;
     }
 
+    template <PieceColor Us>
     Bitboard getPinned(const Position& position) {
-        const uint8_t kingSquare = position.getFriendlyKingSquare();
+        const uint8_t king = kingSquare<Us>(position);
         const Bitboard occupied = position.getOccupied();
-        const Bitboard friendly = position.getFriendlyBitboard();
+        const Bitboard friendly = position.getColorBitboard(Us);
         Bitboard pinned{};
 
         const Bitboard rookMovesFromKing =
-            PregeneratedMoves::getRookMoves(kingSquare, occupied);
-        Bitboard orthogonal = position.getOpponentOrthogonal();
-        while (orthogonal) {
-            const uint8_t square = orthogonal.popLSB();
+            PregeneratedMoves::getRookMoves(king, occupied);
+        Bitboard orthogonals = orthogonal<Them<Us>>(position);
+        while (orthogonals) {
+            const uint8_t square = orthogonals.popLSB();
             const Bitboard moves = PregeneratedMoves::getRookMoves(square, occupied);
             pinned |= moves & rookMovesFromKing & friendly &
-                PregeneratedMoves::getLine(kingSquare, square);
+                PregeneratedMoves::getLine(king, square);
         }
 
         const Bitboard bishopMovesFromKing =
-            PregeneratedMoves::getBishopMoves(kingSquare, occupied);
-        Bitboard diagonal = position.getOpponentDiagonal();
-        while (diagonal) {
-            const uint8_t square = diagonal.popLSB();
+            PregeneratedMoves::getBishopMoves(king, occupied);
+        Bitboard diagonals = diagonal<Them<Us>>(position);
+        while (diagonals) {
+            const uint8_t square = diagonals.popLSB();
             const Bitboard moves = PregeneratedMoves::getBishopMoves(square, occupied);
             pinned |= moves & bishopMovesFromKing & friendly &
-                PregeneratedMoves::getLine(kingSquare, square);
+                PregeneratedMoves::getLine(king, square);
         }
         return pinned;
     }
 
-    void addBitboardMoves(MoveList& legalMoves, Bitboard bitboard, uint8_t start) {
+    void addBitboardMoves(MoveList& legalMoves, Bitboard bitboard, uint8_t start,
+        MoveFlag flag) {
+        while (bitboard) {
+            uint8_t target = bitboard.popLSB();
+            legalMoves.add({ start, target, flag });
+        }
+    }
+
+    // flags the targets holding an enemy piece as captures
+    void addBitboardMoves(MoveList& legalMoves, Bitboard bitboard, uint8_t start,
+        Bitboard enemies) {
         while (bitboard) {
             uint8_t target = bitboard.popLSB();
-            legalMoves.add({ start, target });
+            legalMoves.add({ start, target,
+                enemies.checkBit(target) ? MoveFlag::Capture : MoveFlag::Quiet });
         }
     }
 
     // ignore castling for now
+    template <PieceColor Us>
     void addKingMoves(MoveList& legalMoves, const Position& position,
         Bitboard dangerSquares, bool onlyCaptures) {
-        const uint8_t kingSquare = position.getFriendlyKingSquare();
-        const Bitboard friendly = position.getFriendlyBitboard();
-        Bitboard kingMoves =
-            PregeneratedMoves::getKingMoves(kingSquare) & ~dangerSquares & ~friendly;
+        const uint8_t king = kingSquare<Us>(position);
+        Bitboard kingMoves = PregeneratedMoves::getKingMoves(king) & ~dangerSquares &
+            ~position.getColorBitboard(Us);
         if (onlyCaptures) {
-            kingMoves &= position.getOpponentBitboard();
+            kingMoves &= position.getColorBitboard(Them<Us>);
         }
-        addBitboardMoves(legalMoves, kingMoves, kingSquare);
+        addBitboardMoves(legalMoves, kingMoves, king, position.getColorBitboard(Them<Us>));
     }
 
+    template <PieceColor Us>
     void addSlidingMoves(MoveList& legalMoves, const Position& position,
         Bitboard checkMask, Bitboard pinned, bool onlyCaptures) {
-        Bitboard mask = checkMask & ~position.getFriendlyBitboard();
+        Bitboard mask = checkMask & ~position.getColorBitboard(Us);
         if (onlyCaptures) {
-            mask &= position.getOpponentBitboard();
+            mask &= position.getColorBitboard(Them<Us>);
         }
-        const uint8_t kingSquare = position.getFriendlyKingSquare();
+        const uint8_t king = kingSquare<Us>(position);
+        const Bitboard occupied = position.getOccupied();
+        const Bitboard enemies = position.getColorBitboard(Them<Us>);
 
-        Bitboard orthogonal = position.getFriendlyOrthogonal();
-        while (orthogonal) {
-            const uint8_t square = orthogonal.popLSB();
-            Bitboard moves =
-                PregeneratedMoves::getRookMoves(square, position.getOccupied()) & mask;
+        Bitboard orthogonals = orthogonal<Us>(position);
+        while (orthogonals) {
+            const uint8_t square = orthogonals.popLSB();
+            Bitboard moves = PregeneratedMoves::getRookMoves(square, occupied) & mask;
             if (pinned.checkBit(square)) {
-                moves &= PregeneratedMoves::getLine(kingSquare, square);
+                moves &= PregeneratedMoves::getLine(king, square);
             }
-            addBitboardMoves(legalMoves, moves, square);
+            addBitboardMoves(legalMoves, moves, square, enemies);
         }
 
-        Bitboard diagonal = position.getFriendlyDiagonal();
-        while (diagonal) {
-            const uint8_t square = diagonal.popLSB();
-            Bitboard moves =
-                PregeneratedMoves::getBishopMoves(square, position.getOccupied()) &
-                mask;
+        Bitboard diagonals = diagonal<Us>(position);
+        while (diagonals) {
+            const uint8_t square = diagonals.popLSB();
+            Bitboard moves = PregeneratedMoves::getBishopMoves(square, occupied) & mask;
             if (pinned.checkBit(square)) {
-                moves &= PregeneratedMoves::getLine(kingSquare, square);
+                moves &= PregeneratedMoves::getLine(king, square);
             }
-            addBitboardMoves(legalMoves, moves, square);
+            addBitboardMoves(legalMoves, moves, square, enemies);
         }
     }
 
+    template <PieceColor Us>
     void addKnightMoves(MoveList& legalMoves, const Position& position,
         Bitboard checkMask, Bitboard pinned, bool onlyCaptures) {
-        Bitboard mask = checkMask & ~position.getFriendlyBitboard();
+        Bitboard mask = checkMask & ~position.getColorBitboard(Us);
         if (onlyCaptures) {
-            mask &= position.getOpponentBitboard();
+            mask &= position.getColorBitboard(Them<Us>);
         }
-        Bitboard knights =
-            position.getFriendlyKnights() & ~pinned;  // pinned knights cant move
+        const Bitboard enemies = position.getColorBitboard(Them<Us>);
+        Bitboard knights = position.getBitboard(PieceType::Knight, Us) &
+            ~pinned;  // pinned knights cant move
         while (knights) {
             const uint8_t square = knights.popLSB();
             Bitboard moves = PregeneratedMoves::getKnightMoves(square) & mask;
-            addBitboardMoves(legalMoves, moves, square);
+            addBitboardMoves(legalMoves, moves, square, enemies);
         }
     }
 
+    // a pinned piece may only move along the line through its king
+    bool staysOnPinLine(Bitboard pinned, uint8_t king, uint8_t start, uint8_t target) {
+        return !pinned.checkBit(start) ||
+            PregeneratedMoves::getLine(king, start).checkBit(target);
+    }
+
     void tryAddPawnMove(MoveList& legalMoves, Bitboard pinned, uint8_t kingSquare,
-        uint8_t start, uint8_t end) {
+        uint8_t start, uint8_t end, MoveFlag flag) {
         if (!pinned.checkBit(start) ||
             PregeneratedMoves::getLine(start, kingSquare) ==
             PregeneratedMoves::getLine(start, end)) {
-            legalMoves.add({ start, end });
+            legalMoves.add({ start, end, flag });
         }
     }
 
     void tryAddPromotions(MoveList& legalMoves, Bitboard pinned, uint8_t kingSquare,
-        uint8_t start, uint8_t end) {
+        uint8_t start, uint8_t end, bool capture) {
         if (!pinned.checkBit(start) ||
             PregeneratedMoves::getLine(start, kingSquare) ==
             PregeneratedMoves::getLine(start, end)) {
-            legalMoves.add({ start, end, PieceType::Bishop });
-            legalMoves.add({ start, end, PieceType::Knight });
-            legalMoves.add({ start, end, PieceType::Rook });
-            legalMoves.add({ start, end, PieceType::Queen });
+            legalMoves.add({ start, end, promotionFlag(PieceType::Bishop, capture) });
+            legalMoves.add({ start, end, promotionFlag(PieceType::Knight, capture) });
+            legalMoves.add({ start, end, promotionFlag(PieceType::Rook, capture) });
+            legalMoves.add({ start, end, promotionFlag(PieceType::Queen, capture) });
         }
     }
 
+    // WHY DOES EN PASSANT EXIST???? GOOD LUCK READING THIS
+    // Calls visit(start, target) for every legal en passant capture
+    template <PieceColor Us, typename Visit>
+    void visitEnPassantMoves(const Position& position, Bitboard checkMask,
+        Bitboard pinned, Visit visit) {
+        if (!position.canEnPassant()) return;
+
+        constexpr int offset = pawnOffset<Us>;
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Us);
+        const uint8_t king = kingSquare<Us>(position);
+        const uint8_t target = position.getEnPassantTarget();
+        // the pawn that would be captured
+        const Bitboard victim = forward<Them<Us>>(position.getEnPassantTargetBitboard());
+        const Bitboard enPassantTarget = forward<Us>(victim & checkMask);
+        const Bitboard enemyOrthogonal = orthogonal<Them<Us>>(position);
+
+        if (forwardWest<Us>(pawns) & enPassantTarget) {
+            const uint8_t start = target - offset + 1;
+            const Bitboard kingRay = PregeneratedMoves::getRookMoves(
+                king, position.getOccupied() & ~victim & ~(victim.east()));
+            if ((PregeneratedMoves::getLine(king, target - offset) !=
+                PregeneratedMoves::getLine(king, start) ||
+                !(kingRay & enemyOrthogonal)) &&
+                staysOnPinLine(pinned, king, start, target)) {
+                visit(start, target);
+            }
+        }
+
+        if (forwardEast<Us>(pawns) & enPassantTarget) {
+            const uint8_t start = target - offset - 1;
+            const Bitboard kingRay = PregeneratedMoves::getRookMoves(
+                king, position.getOccupied() & ~victim & ~(victim.west()));
+            if ((PregeneratedMoves::getLine(king, target - offset) !=
+                PregeneratedMoves::getLine(king, start) ||
+                !(kingRay & enemyOrthogonal)) &&
+                staysOnPinLine(pinned, king, start, target)) {
+                visit(start, target);
+            }
+        }
+    }
+
+    template <PieceColor Us>
+    void addEnPassantMoves(MoveList& legalMoves, const Position& position,
+        Bitboard checkMask, Bitboard pinned) {
+        visitEnPassantMoves<Us>(position, checkMask, pinned,
+            [&legalMoves](uint8_t start, uint8_t target) {
+                legalMoves.add({ start, target, MoveFlag::EnPassant });
+            });
+    }
+
+    template <PieceColor Us>
     void addPawnMoves(MoveList& legalMoves, const Position& position,
         Bitboard checkMask, Bitboard pinned, bool onlyCaptures) {
-        const Bitboard pawns = position.getFriendlyPawns();
-        const Bitboard pushMask = checkMask & ~position.getOccupied();
-        const Bitboard captureMask = checkMask & position.getOpponentBitboard();
-
-        Bitboard advanceOne;
-        Bitboard advanceTwo;
-        Bitboard captureLeft;
-        Bitboard captureRight;
-        Bitboard enPassantLeft;
-        Bitboard enPassantRight;
-        Bitboard promotionLeft;
-        Bitboard promotionPush;
-        Bitboard promotionRight;
-
-        int offset;
-
-        if (position.getTurn() == PieceColor::White) {
-            const Bitboard north = pawns.north() & ~position.getOccupied();
-            advanceOne = north & checkMask & ~Bitboard::mask8();
-            promotionPush = north & checkMask & Bitboard::mask8();
-            advanceTwo = (north & Bitboard::mask3()).north() & pushMask;
-
-            const Bitboard northEast = pawns.northEast() & captureMask;
-            captureRight = northEast & ~Bitboard::mask8();
-            promotionRight = northEast & Bitboard::mask8();
-
-            const Bitboard northWest = pawns.northWest() & captureMask;
-            captureLeft = northWest & ~Bitboard::mask8();
-            promotionLeft = northWest & Bitboard::mask8();
-
-            const Bitboard enPassantTarget =
-                (position.getEnPassantTargetBitboard().south() & checkMask).north();
-            enPassantLeft = pawns.northWest() & enPassantTarget;
-            enPassantRight = pawns.northEast() & enPassantTarget;
-
-            offset = -8;
-        }
-        else {
-            const Bitboard south = pawns.south() & ~position.getOccupied();
-            advanceOne = south & checkMask & ~Bitboard::mask1();
-            promotionPush = south & checkMask & Bitboard::mask1();
-            advanceTwo = (south & Bitboard::mask6()).south() & pushMask;
-
-            const Bitboard southEast = pawns.southEast() & captureMask;
-            captureRight = southEast & ~Bitboard::mask1();
-            promotionRight = southEast & Bitboard::mask1();
-
-            const Bitboard southWest = pawns.southWest() & captureMask;
-            captureLeft = southWest & ~Bitboard::mask1();
-            promotionLeft = southWest & Bitboard::mask1();
-
-            const Bitboard enPassantTarget =
-                (position.getEnPassantTargetBitboard().north() & checkMask).south();
-            enPassantLeft = pawns.southWest() & enPassantTarget;
-            enPassantRight = pawns.southEast() & enPassantTarget;
-
-            offset = 8;
-        }
-
-        const uint8_t kingSquare = position.getFriendlyKingSquare();
+        constexpr int offset = pawnOffset<Us>;
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Us);
+        const Bitboard empty = ~position.getOccupied();
+        const Bitboard captureMask = checkMask & position.getColorBitboard(Them<Us>);
+        const uint8_t king = kingSquare<Us>(position);
+
         if (!onlyCaptures) {
+            const Bitboard pushed = forward<Us>(pawns) & empty;
+            Bitboard advanceOne = pushed & checkMask & ~promotionRank<Us>;
+            Bitboard promotionPush = pushed & checkMask & promotionRank<Us>;
+            Bitboard advanceTwo =
+                forward<Us>(pushed & doublePushRank<Us>) & empty & checkMask;
+
             while (advanceOne) {
                 const uint8_t square = advanceOne.popLSB();
-                tryAddPawnMove(legalMoves, pinned, kingSquare, square - offset, square);
+                tryAddPawnMove(legalMoves, pinned, king, square - offset, square,
+                    MoveFlag::Quiet);
             }
 
             while (advanceTwo) {
                 const uint8_t square = advanceTwo.popLSB();
-                tryAddPawnMove(legalMoves, pinned, kingSquare, square - 2 * offset,
-                    square);
+                tryAddPawnMove(legalMoves, pinned, king, square - 2 * offset, square,
+                    MoveFlag::DoublePush);
             }
             while (promotionPush) {
                 const uint8_t square = promotionPush.popLSB();
-                tryAddPromotions(legalMoves, pinned, kingSquare, square - offset, square);
+                tryAddPromotions(legalMoves, pinned, king, square - offset, square, false);
             }
         }
 
+        const Bitboard west = forwardWest<Us>(pawns) & captureMask;
+        Bitboard captureLeft = west & ~promotionRank<Us>;
+        Bitboard promotionLeft = west & promotionRank<Us>;
+
+        const Bitboard east = forwardEast<Us>(pawns) & captureMask;
+        Bitboard captureRight = east & ~promotionRank<Us>;
+        Bitboard promotionRight = east & promotionRank<Us>;
+
         while (captureLeft) {
             const uint8_t square = captureLeft.popLSB();
-            tryAddPawnMove(legalMoves, pinned, kingSquare, square - offset + 1, square);
+            tryAddPawnMove(legalMoves, pinned, king, square - offset + 1, square,
+                MoveFlag::Capture);
         }
 
         while (captureRight) {
             const uint8_t square = captureRight.popLSB();
-            tryAddPawnMove(legalMoves, pinned, kingSquare, square - offset - 1, square);
+            tryAddPawnMove(legalMoves, pinned, king, square - offset - 1, square,
+                MoveFlag::Capture);
         }
 
         while (promotionLeft) {
             const uint8_t square = promotionLeft.popLSB();
-            tryAddPromotions(legalMoves, pinned, kingSquare, square - offset + 1,
-                square);
+            tryAddPromotions(legalMoves, pinned, king, square - offset + 1, square, true);
         }
 
         while (promotionRight) {
             const uint8_t square = promotionRight.popLSB();
-            tryAddPromotions(legalMoves, pinned, kingSquare, square - offset - 1,
-                square);
-        }
-
-        // WHY DOES EN PASSANT EXIST???? GOOD LUCK READING THIS
-        if (position.canEnPassant()) {
-            const Bitboard enPassantTarget =
-                position.getTurn() == PieceColor::White
-                ? position.getEnPassantTargetBitboard().south()
-                : position.getEnPassantTargetBitboard().north();
-            if (enPassantLeft) {
-                const Bitboard kingRay = PregeneratedMoves::getRookMoves(
-                    kingSquare, position.getOccupied() & ~enPassantTarget &
-                    ~(enPassantTarget.east()));
-                if (PregeneratedMoves::getLine(kingSquare,
-                    position.getEnPassantTarget() - offset) !=
-                    PregeneratedMoves::getLine(
-                        kingSquare, position.getEnPassantTarget() - offset + 1) ||
-                    !(kingRay & position.getOpponentOrthogonal())) {
-                    tryAddPawnMove(legalMoves, pinned, kingSquare,
-                        position.getEnPassantTarget() - offset + 1,
-                        position.getEnPassantTarget());
-                }
-            }
-
-            if (enPassantRight) {
-                const Bitboard kingRay = PregeneratedMoves::getRookMoves(
-                    kingSquare, position.getOccupied() & ~enPassantTarget &
-                    ~(enPassantTarget.west()));
-                if (PregeneratedMoves::getLine(kingSquare,
-                    position.getEnPassantTarget() - offset) !=
-                    PregeneratedMoves::getLine(
-                        kingSquare, position.getEnPassantTarget() - offset - 1) ||
-                    !(kingRay & position.getOpponentOrthogonal())) {
-                    tryAddPawnMove(legalMoves, pinned, kingSquare,
-                        position.getEnPassantTarget() - offset - 1,
-                        position.getEnPassantTarget());
-                }
-            }
+            tryAddPromotions(legalMoves, pinned, king, square - offset - 1, square, true);
         }
+
+        addEnPassantMoves<Us>(legalMoves, position, checkMask, pinned);
     }
 
+    template <PieceColor Us>
     void addCastlingMoves(MoveList& legalMoves, const Position& position,
         Bitboard dangerSquares) {
-        const uint8_t kingSquare = position.getFriendlyKingSquare();
+        const uint8_t king = kingSquare<Us>(position);
 
-        const Bitboard kingsideCastleMask = position.getTurn() == PieceColor::White
-            ? Bitboard{ 0b11ULL << 61 }
-        : Bitboard{ 0b11ULL << 5 };
         if (position.canCastleKingside() &&
-            !(position.getOccupied() & kingsideCastleMask) &&
-            !(dangerSquares & kingsideCastleMask)) {
-            legalMoves.add({ kingSquare, static_cast<uint8_t>(kingSquare + 2) });
+            !(position.getOccupied() & kingsideCastleMask<Us>) &&
+            !(dangerSquares & kingsideCastleMask<Us>)) {
+            legalMoves.add({ king, static_cast<uint8_t>(king + 2), MoveFlag::KingCastle });
         }
 
-        const Bitboard queensideCastleFriendlyMask =
-            position.getTurn() == PieceColor::White ? Bitboard{ 0b111ULL << 57 }
-        : Bitboard{ 0b111ULL << 1 };
-        const Bitboard queensideCastleDangerMask =
-            position.getTurn() == PieceColor::White ? Bitboard{ 0b11ULL << 58 }
-        : Bitboard{ 0b11ULL << 2 };
         if (position.canCastleQueenside() &&
-            !(position.getOccupied() & queensideCastleFriendlyMask) &&
-            !(dangerSquares & queensideCastleDangerMask)) {
-            legalMoves.add({ kingSquare, static_cast<uint8_t>(kingSquare - 2) });
+            !(position.getOccupied() & queensideCastleFriendlyMask<Us>) &&
+            !(dangerSquares & queensideCastleDangerMask<Us>)) {
+            legalMoves.add({ king, static_cast<uint8_t>(king - 2), MoveFlag::QueenCastle });
         }
     }
 
-}  // namespace
+    // Pawn moves landing inside mask, for pawns that share the same pin
+    // situation. Promotions count once per piece they can become.
+    template <PieceColor Us>
+    int countPawnMoves(Bitboard pawns, Bitboard empty, Bitboard enemies, Bitboard mask) {
+        const Bitboard pushed = forward<Us>(pawns) & empty;
+        const Bitboard single = pushed & mask;
+        const Bitboard twice = forward<Us>(pushed & doublePushRank<Us>) & empty & mask;
+        const Bitboard west = forwardWest<Us>(pawns) & enemies & mask;
+        const Bitboard east = forwardEast<Us>(pawns) & enemies & mask;
+
+        const auto withPromotions = [](Bitboard targets) {
+            return (targets & ~promotionRank<Us>).numBits() +
+                4 * (targets & promotionRank<Us>).numBits();
+        };
+        return withPromotions(single) + twice.numBits() + withPromotions(west) +
+            withPromotions(east);
+    }
 
-bool MoveGenerator::generateLegal(const Position& position,
-    MoveList& legalMoves, bool onlyCaptures) {
-    legalMoves.clear();
-    const Bitboard attackers = getAttackers(position);
-    const Bitboard dangerSquares = getDangerSquares(position);
+    template <PieceColor Us>
+    CheckInfo computeCheckInfo(const Position& position) {
+        CheckInfo info{};
+        info.checkers = getAttackers<Us>(position);
+        info.dangers = getDangerSquares<Us>(position);
+        info.pinned = getPinned<Us>(position);
+
+        const int numCheckers = info.checkers.numBits();
+        if (numCheckers == 0) {
+            info.checkMask = Bitboard::full();
+        }
+        else if (numCheckers == 1) {
+            // bishop, queen, or rook check means we can block or capture
+            if ((orthogonal<Them<Us>>(position) | diagonal<Them<Us>>(position)) &
+                info.checkers) {
+                info.checkMask = PregeneratedMoves::getBetween(kingSquare<Us>(position),
+                    info.checkers.getLSBIndex());
+            }
+            // knight, pawn means we have to capture
+            else {
+                info.checkMask = info.checkers;
+            }
+        }
+        return info;
+    }
+
+    template <PieceColor Us>
+    bool generateLegal(const Position& position, MoveList& legalMoves,
+        bool onlyCaptures) {
+        legalMoves.clear();
+        // a copy, so the compiler knows adding moves leaves it untouched
+        const CheckInfo info = position.getCheckInfo();
+
+        addKingMoves<Us>(legalMoves, position, info.dangers, onlyCaptures);
+
+        // only the king can escape a double check
+        if (!info.checkMask) {
+            return true;
+        }
+        if (!info.checkers && !onlyCaptures) {
+            addCastlingMoves<Us>(legalMoves, position, info.dangers);
+        }
+
+        addSlidingMoves<Us>(legalMoves, position, info.checkMask, info.pinned, onlyCaptures);
+        addKnightMoves<Us>(legalMoves, position, info.checkMask, info.pinned, onlyCaptures);
+        addPawnMoves<Us>(legalMoves, position, info.checkMask, info.pinned, onlyCaptures);
+        return info.checkers;
+    }
+    // queen promotions only, underpromoting is rarely worth a quiescence node
+    template <PieceColor Us>
+    void addQueenPromotions(MoveList& captures, const Position& position,
+        const CheckInfo& info) {
+        constexpr int offset = pawnOffset<Us>;
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Us) &
+            forward<Them<Us>>(promotionRank<Us>);
+        if (!pawns) return;
+
+        const uint8_t king = kingSquare<Us>(position);
+        const Bitboard enemies = position.getColorBitboard(Them<Us>) & info.checkMask;
+
+        Bitboard west = forwardWest<Us>(pawns) & enemies;
+        while (west) {
+            const uint8_t square = west.popLSB();
+            if (staysOnPinLine(info.pinned, king, square - offset + 1, square)) {
+                captures.add({ static_cast<uint8_t>(square - offset + 1), square,
+                    MoveFlag::QueenPromotionCapture });
+            }
+        }
+        Bitboard east = forwardEast<Us>(pawns) & enemies;
+        while (east) {
+            const uint8_t square = east.popLSB();
+            if (staysOnPinLine(info.pinned, king, square - offset - 1, square)) {
+                captures.add({ static_cast<uint8_t>(square - offset - 1), square,
+                    MoveFlag::QueenPromotionCapture });
+            }
+        }
+        Bitboard pushes = forward<Us>(pawns) & ~position.getOccupied() & info.checkMask;
+        while (pushes) {
+            const uint8_t square = pushes.popLSB();
+            if (staysOnPinLine(info.pinned, king, square - offset, square)) {
+                captures.add({ static_cast<uint8_t>(square - offset), square,
+                    MoveFlag::QueenPromotion });
+            }
+        }
+    }
+
+    template <PieceColor Us>
+    void generateCaptures(const Position& position, MoveList& captures) {
+        constexpr int offset = pawnOffset<Us>;
+        captures.clear();
+        const CheckInfo info = position.getCheckInfo();
+        const uint8_t king = kingSquare<Us>(position);
+        const Bitboard occupied = position.getOccupied();
+        const Bitboard enemies = position.getColorBitboard(Them<Us>);
+        const Bitboard targetMask = enemies & info.checkMask;
+
+        addQueenPromotions<Us>(captures, position, info);
+
+        // Capture sets of every piece but the pawns, least valuable first.
+        // Each is computed once and then split up by victim below.
+        struct Attacker {
+            uint8_t square;
+            Bitboard targets;
+        };
+        Array<Attacker, 16> attackers;
+        size_t numAttackers = 0;
+        Bitboard attacked{};
+        const auto addAttackers = [&](PieceType type, auto getTargets) {
+            Bitboard pieces = position.getBitboard(type, Us);
+            while (pieces) {
+                const uint8_t square = pieces.popLSB();
+                Bitboard targets = getTargets(square) & targetMask;
+                if (info.pinned.checkBit(square)) {
+                    targets &= PregeneratedMoves::getLine(king, square);
+                }
+                if (targets) {
+                    attackers[numAttackers++] = { square, targets };
+                    attacked |= targets;
+                }
+            }
+        };
+        addAttackers(PieceType::Knight, [](uint8_t square) {
+            return PregeneratedMoves::getKnightMoves(square);
+        });
+        addAttackers(PieceType::Bishop, [occupied](uint8_t square) {
+            return PregeneratedMoves::getBishopMoves(square, occupied);
+        });
+        addAttackers(PieceType::Rook, [occupied](uint8_t square) {
+            return PregeneratedMoves::getRookMoves(square, occupied);
+        });
+        addAttackers(PieceType::Queen, [occupied](uint8_t square) {
+            return PregeneratedMoves::getQueenMoves(square, occupied);
+        });
+        const Bitboard kingTargets =
+            PregeneratedMoves::getKingMoves(king) & enemies & ~info.dangers;
+        if (kingTargets) {
+            attackers[numAttackers++] = { king, kingTargets };
+            attacked |= kingTargets;
+        }
 
-    addKingMoves(legalMoves, position, dangerSquares, onlyCaptures);
+        // pawn captures onto the last rank were added as promotions
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Us);
+        const Bitboard pawnTargets = targetMask & ~promotionRank<Us>;
+        const Bitboard pawnWest = forwardWest<Us>(pawns) & pawnTargets;
+        const Bitboard pawnEast = forwardEast<Us>(pawns) & pawnTargets;
+        attacked |= pawnWest | pawnEast;
+
+        // most valuable victim first
+        for (const PieceType victim : { PieceType::Queen, PieceType::Rook,
+            PieceType::Bishop, PieceType::Knight, PieceType::Pawn }) {
+            const Bitboard victims = position.getBitboard(victim, Them<Us>) & attacked;
+            if (!victims) continue;
+
+            Bitboard west = pawnWest & victims;
+            while (west) {
+                const uint8_t square = west.popLSB();
+                if (staysOnPinLine(info.pinned, king, square - offset + 1, square)) {
+                    captures.add({ static_cast<uint8_t>(square - offset + 1), square,
+                        MoveFlag::Capture });
+                }
+            }
+            Bitboard east = pawnEast & victims;
+            while (east) {
+                const uint8_t square = east.popLSB();
+                if (staysOnPinLine(info.pinned, king, square - offset - 1, square)) {
+                    captures.add({ static_cast<uint8_t>(square - offset - 1), square,
+                        MoveFlag::Capture });
+                }
+            }
+            for (size_t i = 0; i < numAttackers; i++) {
+                addBitboardMoves(captures, attackers[i].targets & victims,
+                    attackers[i].square, MoveFlag::Capture);
+            }
+        }
+        addEnPassantMoves<Us>(captures, position, info.checkMask, info.pinned);
+    }
 
-    const int numAttackers = attackers.numBits();
-    if (numAttackers > 1) {
-        return true;
+    template <PieceColor Us>
+    CheckingSquares computeCheckingSquares(const Position& position) {
+        CheckingSquares checking{};
+        const uint8_t king = kingSquare<Them<Us>>(position);
+        const Bitboard kingBoard = Bitboard::fromSquare(king);
+        const Bitboard occupied = position.getOccupied();
+        const Bitboard bishopRays = PregeneratedMoves::getBishopMoves(king, occupied);
+        const Bitboard rookRays = PregeneratedMoves::getRookMoves(king, occupied);
+
+        // our pawns check from where an enemy pawn on the king square would capture
+        checking.squares[static_cast<uint8_t>(PieceType::Pawn)] =
+            forwardEast<Them<Us>>(kingBoard) | forwardWest<Them<Us>>(kingBoard);
+        checking.squares[static_cast<uint8_t>(PieceType::Knight)] =
+            PregeneratedMoves::getKnightMoves(king);
+        checking.squares[static_cast<uint8_t>(PieceType::Bishop)] = bishopRays;
+        checking.squares[static_cast<uint8_t>(PieceType::Rook)] = rookRays;
+        checking.squares[static_cast<uint8_t>(PieceType::Queen)] = bishopRays | rookRays;
+
+        // our sliders lined up with the king behind exactly one piece of ours
+        Bitboard snipers =
+            (PregeneratedMoves::getRookMoves(king, Bitboard::empty()) &
+                orthogonal<Us>(position)) |
+            (PregeneratedMoves::getBishopMoves(king, Bitboard::empty()) &
+                diagonal<Us>(position));
+        while (snipers) {
+            const uint8_t square = snipers.popLSB();
+            const Bitboard blockers = PregeneratedMoves::getBetween(king, square) &
+                occupied & ~Bitboard::fromSquare(square);
+            if (blockers.numBits() == 1 && (blockers & position.getColorBitboard(Us))) {
+                checking.discoverers |= blockers;
+            }
+        }
+        return checking;
     }
 
-    Bitboard mask = Bitboard::full();
-    if (numAttackers == 1) {
-        const uint8_t square = attackers.getLSBIndex();
-        // bishop, queen, or rook check means we can block or capture
-        if ((position.getOpponentOrthogonal() | position.getOpponentDiagonal()) &
-            attackers) {
-            mask = PregeneratedMoves::getBetween(position.getFriendlyKingSquare(),
-                square);
-            // knight, pawn means we have to capture
+    template <PieceColor Us>
+    bool givesCheck(const Position& position, Move move) {
+        const CheckingSquares& checking = position.getCheckingSquares();
+        const uint8_t king = kingSquare<Them<Us>>(position);
+        const uint8_t start = move.start();
+        const uint8_t target = move.target();
+        const PieceType placed = move.isPromotion() ? move.promotion() :
+            position.getPieceAt(start).type;
+
+        // the entry for the king is empty, it can only check by discovery
+        if (checking.squares[static_cast<uint8_t>(placed)].checkBit(target)) {
+            return true;
         }
-        else {
-            mask = attackers;
+        if (checking.discoverers.checkBit(start) &&
+            !PregeneratedMoves::getLine(king, start).checkBit(target)) {
+            return true;
+        }
+
+        const Bitboard from = Bitboard::fromSquare(start);
+        const Bitboard to = Bitboard::fromSquare(target);
+
+        // the pawn itself may have been blocking the promoted piece's line
+        if (move.isPromotion()) {
+            const Bitboard occupied = position.getOccupied() & ~from;
+            Bitboard attacks{};
+            switch (placed) {
+            case PieceType::Knight:
+                attacks = PregeneratedMoves::getKnightMoves(target);
+                break;
+            case PieceType::Bishop:
+                attacks = PregeneratedMoves::getBishopMoves(target, occupied);
+                break;
+            case PieceType::Rook:
+                attacks = PregeneratedMoves::getRookMoves(target, occupied);
+                break;
+            default:
+                attacks = PregeneratedMoves::getQueenMoves(target, occupied);
+                break;
+            }
+            return attacks.checkBit(king);
+        }
+
+        switch (move.flag()) {
+        // taking en passant clears two squares, which can uncover a slider
+        case MoveFlag::EnPassant: {
+            const Bitboard captured = forward<Them<Us>>(to);
+            const Bitboard occupied = (position.getOccupied() & ~from & ~captured) | to;
+            return (PregeneratedMoves::getRookMoves(king, occupied) &
+                orthogonal<Us>(position)) ||
+                (PregeneratedMoves::getBishopMoves(king, occupied) &
+                    diagonal<Us>(position));
+        }
+        // castling can check with the rook
+        case MoveFlag::KingCastle:
+        case MoveFlag::QueenCastle: {
+            const bool kingside = move.flag() == MoveFlag::KingCastle;
+            const uint8_t rookStart = kingside ? start + 3 : start - 4;
+            const uint8_t rookTarget = kingside ? start + 1 : start - 1;
+            const Bitboard occupied = (position.getOccupied() & ~from &
+                ~Bitboard::fromSquare(rookStart)) | to | Bitboard::fromSquare(rookTarget);
+            return PregeneratedMoves::getRookMoves(rookTarget, occupied).checkBit(king);
+        }
+        default:
+            return false;
         }
     }
-    else if (!onlyCaptures) {
-        addCastlingMoves(legalMoves, position, dangerSquares);
+
+    // Mirrors generateLegal, but only popcounts the target sets
+    template <PieceColor Us>
+    int countLegal(const Position& position) {
+        const CheckInfo& info = position.getCheckInfo();
+        const uint8_t king = kingSquare<Us>(position);
+        const Bitboard friendly = position.getColorBitboard(Us);
+        const Bitboard enemies = position.getColorBitboard(Them<Us>);
+        const Bitboard occupied = position.getOccupied();
+
+        int count = (PregeneratedMoves::getKingMoves(king) & ~info.dangers &
+            ~friendly).numBits();
+        if (!info.checkMask) {
+            return count;
+        }
+
+        if (!info.checkers) {
+            if (position.canCastleKingside() &&
+                !(occupied & kingsideCastleMask<Us>) &&
+                !(info.dangers & kingsideCastleMask<Us>)) {
+                count++;
+            }
+            if (position.canCastleQueenside() &&
+                !(occupied & queensideCastleFriendlyMask<Us>) &&
+                !(info.dangers & queensideCastleDangerMask<Us>)) {
+                count++;
+            }
+        }
+
+        const Bitboard mask = info.checkMask & ~friendly;
+        const auto countMoves = [&](Bitboard pieces, auto getMoves) {
+            while (pieces) {
+                const uint8_t square = pieces.popLSB();
+                Bitboard moves = getMoves(square) & mask;
+                if (info.pinned.checkBit(square)) {
+                    moves &= PregeneratedMoves::getLine(king, square);
+                }
+                count += moves.numBits();
+            }
+        };
+        countMoves(orthogonal<Us>(position), [occupied](uint8_t square) {
+            return PregeneratedMoves::getRookMoves(square, occupied);
+        });
+        countMoves(diagonal<Us>(position), [occupied](uint8_t square) {
+            return PregeneratedMoves::getBishopMoves(square, occupied);
+        });
+        // pinned knights cant move
+        countMoves(position.getBitboard(PieceType::Knight, Us) & ~info.pinned,
+            [](uint8_t square) { return PregeneratedMoves::getKnightMoves(square); });
+
+        const Bitboard pawns = position.getBitboard(PieceType::Pawn, Us);
+        const Bitboard empty = ~occupied;
+        count += countPawnMoves<Us>(pawns & ~info.pinned, empty, enemies, info.checkMask);
+        Bitboard pinnedPawns = pawns & info.pinned;
+        while (pinnedPawns) {
+            const uint8_t square = pinnedPawns.popLSB();
+            count += countPawnMoves<Us>(Bitboard::fromSquare(square), empty, enemies,
+                info.checkMask & PregeneratedMoves::getLine(king, square));
+        }
+
+        visitEnPassantMoves<Us>(position, info.checkMask, info.pinned,
+            [&count](uint8_t, uint8_t) { count++; });
+        return count;
     }
-    const Bitboard pinned = getPinned(position);
+}  // namespace
+
+CheckInfo MoveGenerator::computeCheckInfo(const Position& position) {
+    return position.getTurn() == PieceColor::White
+        ? ::computeCheckInfo<PieceColor::White>(position)
+        : ::computeCheckInfo<PieceColor::Black>(position);
+}
+
+CheckingSquares MoveGenerator::computeCheckingSquares(const Position& position) {
+    return position.getTurn() == PieceColor::White
+        ? ::computeCheckingSquares<PieceColor::White>(position)
+        : ::computeCheckingSquares<PieceColor::Black>(position);
+}
+
+bool MoveGenerator::generateLegal(const Position& position,
+    MoveList& legalMoves, bool onlyCaptures) {
+    return position.getTurn() == PieceColor::White
+        ? ::generateLegal<PieceColor::White>(position, legalMoves, onlyCaptures)
+        : ::generateLegal<PieceColor::Black>(position, legalMoves, onlyCaptures);
+}
+
+void MoveGenerator::generateCaptures(const Position& position, MoveList& captures) {
+    if (position.getTurn() == PieceColor::White) {
+        ::generateCaptures<PieceColor::White>(position, captures);
+    }
+    else {
+        ::generateCaptures<PieceColor::Black>(position, captures);
+    }
+}
+
+bool MoveGenerator::givesCheck(const Position& position, Move move) {
+    return position.getTurn() == PieceColor::White
+        ? ::givesCheck<PieceColor::White>(position, move)
+        : ::givesCheck<PieceColor::Black>(position, move);
+}
 
-    addSlidingMoves(legalMoves, position, mask, pinned, onlyCaptures);
-    addKnightMoves(legalMoves, position, mask, pinned, onlyCaptures);
-    addPawnMoves(legalMoves, position, mask, pinned, onlyCaptures);
-    return attackers;
+int MoveGenerator::countLegal(const Position& position) {
+    return position.getTurn() == PieceColor::White
+        ? ::countLegal<PieceColor::White>(position)
+        : ::countLegal<PieceColor::Black>(position);
 }
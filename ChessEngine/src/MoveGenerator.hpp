@@ -6,10 +6,30 @@
 
 namespace Chess {
     class Position;
+    struct CheckInfo;
+    struct CheckingSquares;
 
     namespace MoveGenerator {
+        // Prefer Position::getCheckInfo, which caches the result
+        CheckInfo computeCheckInfo(const Position& position);
+        // Prefer Position::getCheckingSquares, which caches the result
+        CheckingSquares computeCheckingSquares(const Position& position);
+
         // returns bool indicating whether in check (not clean but efficient)
         bool generateLegal(const Position& position, MoveList& legalMoves,
             bool onlyCaptures = false);
+
+        // Number of legal moves, counted from the target bitboards without
+        // building a move list
+        int countLegal(const Position& position);
+
+        // Legal captures and queen promotions for quiescence search, already in
+        // most valuable victim, least valuable attacker order. Promotions come
+        // first. In check only captures that resolve it are produced.
+        void generateCaptures(const Position& position, MoveList& captures);
+
+        // Whether a legal move checks the enemy king, without making it. Cheap
+        // enough to ask for every move once the checking squares are cached.
+        bool givesCheck(const Position& position, Move move);
     }  // namespace MoveGenerator
 }
@@ -0,0 +1,271 @@
+#include "Nnue.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Cpu.hpp"
+#include "Position.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define CHESS_SIMD_AVAILABLE
+#if defined(__GNUC__) || defined(__clang__)
+// only the AVX2 kernels may use AVX2, everything else must run on any x86-64
+#define CHESS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHESS_TARGET_AVX2
+#endif
+#endif
+
+using namespace Chess;
+using namespace Chess::Nnue;
+
+namespace {
+    struct Network {
+        alignas(32) Array2D<int16_t, k_inputs, k_hidden> featureWeights{};
+        alignas(32) Array<int16_t, k_hidden> featureBiases{};
+        alignas(32) Array<int16_t, 2 * k_hidden> outputWeights{};
+        int32_t outputBias{};
+    };
+
+    // Accumulator rows and weight rows are k_hidden int16 long and 32 byte
+    // aligned, which every kernel relies on
+    struct Kernels {
+        void (*add)(int16_t* values, const int16_t* weights);
+        void (*sub)(int16_t* values, const int16_t* weights);
+        void (*addSub)(int16_t* values, const int16_t* added, const int16_t* removed);
+        // clipped ReLU of both perspectives dotted with the output weights
+        int32_t (*output)(const int16_t* us, const int16_t* them, const int16_t* weights);
+    };
+
+    void addScalar(int16_t* values, const int16_t* weights) {
+        for (int i = 0; i < k_hidden; i++) {
+            values[i] += weights[i];
+        }
+    }
+
+    void subScalar(int16_t* values, const int16_t* weights) {
+        for (int i = 0; i < k_hidden; i++) {
+            values[i] -= weights[i];
+        }
+    }
+
+    void addSubScalar(int16_t* values, const int16_t* added, const int16_t* removed) {
+        for (int i = 0; i < k_hidden; i++) {
+            values[i] += added[i] - removed[i];
+        }
+    }
+
+    int32_t outputScalar(const int16_t* us, const int16_t* them, const int16_t* weights) {
+        int32_t sum = 0;
+        for (int i = 0; i < k_hidden; i++) {
+            sum += std::clamp<int32_t>(us[i], 0, k_qa) * weights[i];
+            sum += std::clamp<int32_t>(them[i], 0, k_qa) * weights[k_hidden + i];
+        }
+        return sum;
+    }
+
+    constexpr Kernels scalarKernels{ addScalar, subScalar, addSubScalar, outputScalar };
+
+#ifdef CHESS_SIMD_AVAILABLE
+    // SSE2 is part of x86-64, so these need no check
+    void addSse2(int16_t* values, const int16_t* weights) {
+        for (int i = 0; i < k_hidden; i += 8) {
+            __m128i* v = reinterpret_cast<__m128i*>(values + i);
+            _mm_store_si128(v, _mm_add_epi16(_mm_load_si128(v),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i))));
+        }
+    }
+
+    void subSse2(int16_t* values, const int16_t* weights) {
+        for (int i = 0; i < k_hidden; i += 8) {
+            __m128i* v = reinterpret_cast<__m128i*>(values + i);
+            _mm_store_si128(v, _mm_sub_epi16(_mm_load_si128(v),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i))));
+        }
+    }
+
+    void addSubSse2(int16_t* values, const int16_t* added, const int16_t* removed) {
+        for (int i = 0; i < k_hidden; i += 8) {
+            __m128i* v = reinterpret_cast<__m128i*>(values + i);
+            const __m128i delta = _mm_sub_epi16(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(added + i)),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(removed + i)));
+            _mm_store_si128(v, _mm_add_epi16(_mm_load_si128(v), delta));
+        }
+    }
+
+    int32_t outputSse2(const int16_t* us, const int16_t* them, const int16_t* weights) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i qa = _mm_set1_epi16(k_qa);
+        __m128i sum = zero;
+        for (const int16_t* values : { us, them }) {
+            for (int i = 0; i < k_hidden; i += 8) {
+                const __m128i clipped = _mm_min_epi16(_mm_max_epi16(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(values + i)), zero), qa);
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(clipped,
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i))));
+            }
+            weights += k_hidden;
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+    constexpr Kernels sse2Kernels{ addSse2, subSse2, addSubSse2, outputSse2 };
+
+    CHESS_TARGET_AVX2 void addAvx2(int16_t* values, const int16_t* weights) {
+        for (int i = 0; i < k_hidden; i += 16) {
+            __m256i* v = reinterpret_cast<__m256i*>(values + i);
+            _mm256_store_si256(v, _mm256_add_epi16(_mm256_load_si256(v),
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i))));
+        }
+    }
+
+    CHESS_TARGET_AVX2 void subAvx2(int16_t* values, const int16_t* weights) {
+        for (int i = 0; i < k_hidden; i += 16) {
+            __m256i* v = reinterpret_cast<__m256i*>(values + i);
+            _mm256_store_si256(v, _mm256_sub_epi16(_mm256_load_si256(v),
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i))));
+        }
+    }
+
+    CHESS_TARGET_AVX2 void addSubAvx2(int16_t* values, const int16_t* added,
+        const int16_t* removed) {
+        for (int i = 0; i < k_hidden; i += 16) {
+            __m256i* v = reinterpret_cast<__m256i*>(values + i);
+            const __m256i delta = _mm256_sub_epi16(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(added + i)),
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(removed + i)));
+            _mm256_store_si256(v, _mm256_add_epi16(_mm256_load_si256(v), delta));
+        }
+    }
+
+    CHESS_TARGET_AVX2 int32_t outputAvx2(const int16_t* us, const int16_t* them,
+        const int16_t* weights) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i qa = _mm256_set1_epi16(k_qa);
+        __m256i sum = zero;
+        for (const int16_t* values : { us, them }) {
+            for (int i = 0; i < k_hidden; i += 16) {
+                const __m256i clipped = _mm256_min_epi16(_mm256_max_epi16(
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), zero), qa);
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(clipped,
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i))));
+            }
+            weights += k_hidden;
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum),
+            _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+    }
+
+    constexpr Kernels avx2Kernels{ addAvx2, subAvx2, addSubAvx2, outputAvx2 };
+#endif
+
+    // about 400KB, only allocated once a network is loaded
+    std::unique_ptr<Network> network{};
+    Kernels kernels = scalarKernels;
+    uint32_t generation = 0;
+
+    template <typename T>
+    void read(std::ifstream& in, T& value) {
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    const int16_t* weightsOf(PieceColor perspective, PieceType type, PieceColor color,
+        uint8_t square) {
+        return network->featureWeights[featureIndex(perspective, type, color, square)].data();
+    }
+}  // namespace
+
+void Nnue::load(std::string_view path) {
+    std::ifstream in{ std::string{ path }, std::ios::binary };
+    if (!in) {
+        throw std::runtime_error{ "Failed to open network file" };
+    }
+
+    uint32_t magic = 0;
+    uint32_t hidden = 0;
+    read(in, magic);
+    read(in, hidden);
+    if (!in || magic != k_magic || hidden != k_hidden) {
+        throw std::runtime_error{ "Network file does not match this engine's layout" };
+    }
+
+    auto loaded = std::make_unique<Network>();
+    read(in, loaded->featureWeights);
+    read(in, loaded->featureBiases);
+    read(in, loaded->outputWeights);
+    read(in, loaded->outputBias);
+    if (!in || in.peek() != std::ifstream::traits_type::eof()) {
+        throw std::runtime_error{ "Network file has the wrong size" };
+    }
+
+    network = std::move(loaded);
+    generation++;
+    kernels = scalarKernels;
+#ifdef CHESS_SIMD_AVAILABLE
+    kernels = Cpu::hasAvx2() ? avx2Kernels : sse2Kernels;
+#endif
+}
+
+bool Nnue::isLoaded() {
+    return network != nullptr;
+}
+
+uint32_t Nnue::getGeneration() {
+    return generation;
+}
+
+void Nnue::addPiece(Accumulator& accumulator, PieceType type, PieceColor color,
+    uint8_t square) {
+    for (const PieceColor perspective : { PieceColor::White, PieceColor::Black }) {
+        kernels.add(accumulator.values[static_cast<uint8_t>(perspective)].data(),
+            weightsOf(perspective, type, color, square));
+    }
+}
+
+void Nnue::removePiece(Accumulator& accumulator, PieceType type, PieceColor color,
+    uint8_t square) {
+    for (const PieceColor perspective : { PieceColor::White, PieceColor::Black }) {
+        kernels.sub(accumulator.values[static_cast<uint8_t>(perspective)].data(),
+            weightsOf(perspective, type, color, square));
+    }
+}
+
+void Nnue::movePiece(Accumulator& accumulator, PieceType type, PieceColor color,
+    uint8_t src, uint8_t dst) {
+    for (const PieceColor perspective : { PieceColor::White, PieceColor::Black }) {
+        kernels.addSub(accumulator.values[static_cast<uint8_t>(perspective)].data(),
+            weightsOf(perspective, type, color, dst), weightsOf(perspective, type, color, src));
+    }
+}
+
+void Nnue::refresh(Accumulator& accumulator, const Position& position) {
+    for (auto& values : accumulator.values) {
+        values = network->featureBiases;
+    }
+    for (uint8_t type = 0; type < 6; type++) {
+        for (const PieceColor color : { PieceColor::White, PieceColor::Black }) {
+            Bitboard pieces = position.getBitboard(static_cast<PieceType>(type), color);
+            while (pieces) {
+                addPiece(accumulator, static_cast<PieceType>(type), color, pieces.popLSB());
+            }
+        }
+    }
+}
+
+int Nnue::evaluate(const Accumulator& accumulator, PieceColor turn) {
+    const int64_t sum = kernels.output(
+        accumulator.values[static_cast<uint8_t>(turn)].data(),
+        accumulator.values[static_cast<uint8_t>(oppositeColor(turn))].data(),
+        network->outputWeights.data()) + static_cast<int64_t>(network->outputBias);
+    return static_cast<int>(sum * k_scale / (k_qa * k_qb));
+}
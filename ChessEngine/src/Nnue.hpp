@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "Piece.hpp"
+#include "DataStructures.hpp"
+
+namespace Chess {
+    class Position;
+
+    // An efficiently updatable network, 768 piece square inputs per
+    // perspective to k_hidden clipped ReLU neurons, both perspectives to one
+    // output. Without a loaded network nothing here is used and the hand
+    // written evaluation applies.
+    namespace Nnue {
+        inline constexpr int k_inputs = 768;
+        inline constexpr int k_hidden = 256;
+
+        // The hidden layer is clipped to [0, k_qa], output weights are scaled
+        // by k_qb, and the output is scaled to centipawns by k_scale
+        inline constexpr int k_qa = 255;
+        inline constexpr int k_qb = 64;
+        inline constexpr int k_scale = 400;
+
+        // File layout, all little endian: the magic, k_hidden as a uint32,
+        // int16 feature weights by input then neuron, int16 feature biases,
+        // int16 output weights for the side to move's neurons then the
+        // other side's, and an int32 output bias scaled by k_qa * k_qb
+        inline constexpr uint32_t k_magic = 0x45554E4E;  // "NNUE"
+
+        // Hidden layer sums for both perspectives, indexed by PieceColor
+        struct alignas(32) Accumulator {
+            Array2D<int16_t, 2, k_hidden> values{};
+        };
+
+        // Input of a piece as seen by perspective. Squares count from a8 as
+        // in Position, mirrored vertically for black, and the perspective's
+        // own pieces come first.
+        constexpr int featureIndex(PieceColor perspective, PieceType type, PieceColor color,
+            uint8_t square) {
+            const int relative = perspective == PieceColor::White ? square : square ^ 56;
+            return (color == perspective ? 0 : 384) + static_cast<uint8_t>(type) * 64 + relative;
+        }
+
+        // Reads a network file, throws std::runtime_error if it is missing or
+        // does not match this layout. Picks the widest kernels the CPU has.
+        void load(std::string_view path);
+        bool isLoaded();
+        // counts successful loads, so anything holding evaluations can tell
+        // that the evaluation has changed since
+        uint32_t getGeneration();
+
+        void addPiece(Accumulator& accumulator, PieceType type, PieceColor color,
+            uint8_t square);
+        void removePiece(Accumulator& accumulator, PieceType type, PieceColor color,
+            uint8_t square);
+        void movePiece(Accumulator& accumulator, PieceType type, PieceColor color,
+            uint8_t src, uint8_t dst);
+        void refresh(Accumulator& accumulator, const Position& position);
+
+        // in centipawns for the side to move
+        int evaluate(const Accumulator& accumulator, PieceColor turn);
+    }  // namespace Nnue
+}
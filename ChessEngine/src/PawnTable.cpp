@@ -0,0 +1,104 @@
+#include "PawnTable.hpp"
+
+#include <algorithm>
+
+#include "EvalTrace.hpp"
+#include "Position.hpp"
+#include "TunedWeights.hpp"
+
+using namespace Chess;
+
+namespace {
+    template <PieceColor Us>
+    constexpr Bitboard forward(Bitboard board) {
+        return Us == PieceColor::White ? board.north() : board.south();
+    }
+
+    // every square from board towards the far side of the board, board included
+    template <PieceColor Us>
+    constexpr Bitboard fillForward(Bitboard board) {
+        if constexpr (Us == PieceColor::White) {
+            board |= board >> 8;
+            board |= board >> 16;
+            board |= board >> 32;
+        }
+        else {
+            board |= board << 8;
+            board |= board << 16;
+            board |= board << 32;
+        }
+        return board;
+    }
+
+    template <PieceColor Us>
+    constexpr Bitboard pawnAttacks(Bitboard pawns) {
+        return Us == PieceColor::White ? pawns.northEast() | pawns.northWest()
+            : pawns.southEast() | pawns.southWest();
+    }
+
+    constexpr Bitboard fillFiles(Bitboard board) {
+        return fillForward<PieceColor::White>(board) | fillForward<PieceColor::Black>(board);
+    }
+
+    template <PieceColor Us, typename Sink>
+    void evaluateSide(const Position& position, PawnEntry& entry, Sink& sink) {
+        const EvalWeights::Weights& weights = EvalWeights::weights;
+        constexpr PieceColor Them = Us == PieceColor::White ? PieceColor::Black
+            : PieceColor::White;
+        const Bitboard ours = position.getBitboard(PieceType::Pawn, Us);
+        const Bitboard theirs = position.getBitboard(PieceType::Pawn, Them);
+
+        const Bitboard attackSpan = fillForward<Us>(pawnAttacks<Us>(ours));
+        const Bitboard theirAttackSpan = fillForward<Them>(pawnAttacks<Them>(theirs));
+        const Bitboard theirFrontSpan = fillForward<Them>(forward<Them>(theirs));
+        entry.attackSpans[static_cast<uint8_t>(Us)] = attackSpan;
+
+        const Bitboard files = fillFiles(ours);
+        const Bitboard doubled = ours & fillForward<Them>(forward<Them>(ours));
+        const Bitboard isolated = ours & ~(files.east() | files.west());
+        // the stop square is taken by an enemy pawn and no friendly pawn can
+        // ever come alongside to defend it
+        const Bitboard backward = ours & ~isolated &
+            forward<Them>(pawnAttacks<Them>(theirs) & ~attackSpan);
+        Bitboard passed = ours & ~(theirFrontSpan | theirAttackSpan);
+        entry.passed[static_cast<uint8_t>(Us)] = passed;
+
+        sink.template add<Us>(weights.doubledPawn, doubled.numBits());
+        sink.template add<Us>(weights.isolatedPawn, isolated.numBits());
+        sink.template add<Us>(weights.backwardPawn, backward.numBits());
+        while (passed) {
+            const uint8_t row = passed.popLSB() / 8;
+            sink.template add<Us>(weights.passedPawn[Us == PieceColor::White ? 7 - row : row]);
+        }
+    }
+}  // namespace
+
+const PawnEntry& PawnTable::probe(const Position& position) {
+    const Zobrist key = position.getPawnZobrist();
+    PawnEntry& entry = m_table[static_cast<uint64_t>(key) & (m_table.size() - 1)];
+    if (entry.key != key) {
+        entry = evaluate(position);
+    }
+    return entry;
+}
+
+void PawnTable::clear() {
+    std::fill(m_table.begin(), m_table.end(), PawnEntry{});
+}
+
+PawnEntry PawnTable::evaluate(const Position& position) {
+    PawnEntry entry{};
+    entry.key = position.getPawnZobrist();
+    ScoreSink sink{};
+    evaluateSide<PieceColor::White>(position, entry, sink);
+    evaluateSide<PieceColor::Black>(position, entry, sink);
+    entry.score = sink.score;
+    return entry;
+}
+
+void PawnTable::trace(const Position& position, EvalTrace& trace) {
+    PawnEntry entry{};
+    TraceSink sink{ trace };
+    evaluateSide<PieceColor::White>(position, entry, sink);
+    evaluateSide<PieceColor::Black>(position, entry, sink);
+}
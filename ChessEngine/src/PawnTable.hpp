@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Bitboard.hpp"
+#include "Score.hpp"
+#include "Zobrist.hpp"
+#include "DataStructures.hpp"
+
+namespace Chess {
+    class Position;
+    struct EvalTrace;
+
+    // Everything about a position that depends on its pawns alone, indexed by
+    // PieceColor where there is a bitboard per side
+    struct PawnEntry {
+        Zobrist key;
+        // doubled, isolated, backward and passed pawn terms from white's side
+        Score score;
+        Array<Bitboard, 2> passed;
+        // squares the pawns attack now or could attack after advancing
+        Array<Bitboard, 2> attackSpans;
+    };
+
+    // Pawn structures repeat across most of the search tree, so their terms
+    // are computed once per structure and looked up by the pawn key
+    class PawnTable {
+    public:
+        PawnTable() = default;
+
+        // the entry for position's pawns, evaluated and stored on a miss
+        const PawnEntry& probe(const Position& position);
+
+        void clear();
+
+        static PawnEntry evaluate(const Position& position);
+        // adds the pawn terms of position to trace
+        static void trace(const Position& position, EvalTrace& trace);
+
+    private:
+        // An empty entry matches the pawnless key 0, which is also what
+        // evaluating a position without pawns gives
+        HeapArray<PawnEntry, 1u << 14> m_table{};
+    };
+}
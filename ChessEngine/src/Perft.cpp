@@ -0,0 +1,324 @@
+#include "Perft.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DataStructures.hpp"
+#include "Move.hpp"
+#include "MoveGenerator.hpp"
+#include "Position.hpp"
+#include "ThreadPool.hpp"
+#include "Utils.hpp"
+
+using namespace Chess;
+
+namespace {
+    struct SuiteEntry {
+        std::string_view name;
+        std::string_view fen;
+        // expected leaf counts for depths 1 through 6, 0 where not listed
+        Array<uint64_t, 6> counts;
+    };
+
+    // https://www.chessprogramming.org/Perft_Results
+    constexpr SuiteEntry k_suite[] = {
+        { "startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+          { 20, 400, 8902, 197281, 4865609, 119060324 } },
+        { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          { 48, 2039, 97862, 4085603, 193690690, 0 } },
+        { "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+          { 14, 191, 2812, 43238, 674624, 11030083 } },
+        { "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+          { 6, 264, 9467, 422333, 15833292, 706045033 } },
+        { "position 4 mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+          { 6, 264, 9467, 422333, 15833292, 706045033 } },
+        { "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+          { 44, 1486, 62379, 2103487, 89941194, 0 } },
+        { "position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+          { 46, 2079, 89890, 3894594, 164075551, 0 } },
+    };
+
+    // enough tasks per thread that stealing can even out lopsided subtrees
+    constexpr size_t k_tasksPerThread = 16;
+    constexpr int k_minTaskDepth = 3;
+
+    double millionsPerSecond(uint64_t nodes, double seconds) {
+        return seconds > 0.0 ? nodes / seconds / 1e6 : 0.0;
+    }
+
+    // Shared by all threads without locks. Each slot holds the count xored
+    // into its key check, so a slot torn by two racing writers simply fails
+    // to match instead of returning a wrong count.
+    class PerftHash {
+    public:
+        explicit PerftHash(size_t megabytes) {
+            size_t size = 1;
+            while (2 * size * sizeof(Entry) <= (megabytes << 20)) {
+                size *= 2;
+            }
+            m_entries = std::make_unique<Entry[]>(size);
+            m_mask = size - 1;
+        }
+
+        bool probe(Zobrist key, int depth, uint64_t& nodes) const {
+            const Entry& entry = m_entries[index(key, depth)];
+            const uint64_t data = entry.data.load(std::memory_order_relaxed);
+            const uint64_t check = entry.check.load(std::memory_order_relaxed);
+            if ((check ^ data) != key.get() || (data & 0xFF) != static_cast<uint64_t>(depth)) {
+                return false;
+            }
+            nodes = data >> 8;
+            return true;
+        }
+
+        void store(Zobrist key, int depth, uint64_t nodes) {
+            Entry& entry = m_entries[index(key, depth)];
+            const uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+            entry.check.store(key.get() ^ data, std::memory_order_relaxed);
+            entry.data.store(data, std::memory_order_relaxed);
+        }
+
+    private:
+        struct Entry {
+            std::atomic<uint64_t> check{ 0 };
+            std::atomic<uint64_t> data{ 0 };
+        };
+
+        std::unique_ptr<Entry[]> m_entries;
+        size_t m_mask;
+
+        size_t index(Zobrist key, int depth) const {
+            return (key.get() ^ (depth * 0x9E3779B97F4A7C15ULL)) & m_mask;
+        }
+    };
+
+    uint64_t perftNode(Position& position, int depth, PerftHash* hash) {
+        if (depth == 0) return 1;
+
+        uint64_t nodes = 0;
+        // bulk counted nodes are cheaper to regenerate than to look up
+        if (hash && depth > 1 && hash->probe(position.getZobrist(), depth, nodes)) {
+            return nodes;
+        }
+
+        if (depth == 1) return MoveGenerator::countLegal(position);
+
+        MoveList moves{};
+        MoveGenerator::generateLegal(position, moves);
+
+        for (Move move : moves) {
+            Position::UndoState undo;
+            position.makeMove(move, undo);
+            nodes += perftNode(position, depth - 1, hash);
+            position.unmakeMove(move, undo);
+        }
+        if (hash) {
+            hash->store(position.getZobrist(), depth, nodes);
+        }
+        return nodes;
+    }
+
+    struct Task {
+        Position position;
+        int depth;
+        size_t rootMove;
+    };
+
+    // Leaf counts below each root move. The tree is expanded breadth first
+    // until there are enough independent subtrees to keep every thread busy.
+    std::vector<uint64_t> countRootMoves(const Position& root, int depth,
+        const Perft::Options& options, PerftHash* hash, MoveList& rootMoves) {
+        MoveGenerator::generateLegal(root, rootMoves);
+        std::vector<std::atomic<uint64_t>> counts(rootMoves.size());
+
+        std::vector<Task> tasks{};
+        for (size_t i = 0; i < rootMoves.size(); i++) {
+            Position position{ root };
+            Position::UndoState undo;
+            position.makeMove(rootMoves[i], undo);
+            tasks.push_back({ position, depth - 1, i });
+        }
+
+        const size_t targetTasks = k_tasksPerThread * std::max(options.threads, 1);
+        while (options.threads > 1 && tasks.size() < targetTasks &&
+            !tasks.empty() && tasks.front().depth > k_minTaskDepth) {
+            std::vector<Task> expanded{};
+            for (Task& task : tasks) {
+                MoveList moves{};
+                MoveGenerator::generateLegal(task.position, moves);
+                for (Move move : moves) {
+                    Position position{ task.position };
+                    Position::UndoState undo;
+                    position.makeMove(move, undo);
+                    expanded.push_back({ position, task.depth - 1, task.rootMove });
+                }
+            }
+            tasks = std::move(expanded);
+        }
+
+        if (options.threads <= 1) {
+            for (Task& task : tasks) {
+                counts[task.rootMove] += perftNode(task.position, task.depth, hash);
+            }
+        }
+        else {
+            ThreadPool pool{ options.threads };
+            for (Task& task : tasks) {
+                pool.submit([&task, &counts, hash]() {
+                    counts[task.rootMove] += perftNode(task.position, task.depth, hash);
+                });
+            }
+            pool.wait();
+        }
+
+        return { counts.begin(), counts.end() };
+    }
+
+    // Returns the number of moves checked, mismatches counts the ones where
+    // givesCheck disagreed with the position after the move
+    uint64_t verifyNode(Position& position, int depth, std::vector<Move>& line,
+        uint64_t& mismatches, std::ostream& out) {
+        MoveList moves{};
+        MoveGenerator::generateLegal(position, moves);
+
+        uint64_t checked = 0;
+        for (Move move : moves) {
+            const bool predicted = MoveGenerator::givesCheck(position, move);
+            Position::UndoState undo;
+            position.makeMove(move, undo);
+            line.push_back(move);
+            checked++;
+            if (predicted != position.inCheck()) {
+                mismatches++;
+                out << "givesCheck returned " << std::boolalpha << predicted
+                    << std::noboolalpha << " after";
+                for (Move played : line) {
+                    out << ' ' << Utils::moveToStr(played);
+                }
+                out << '\n';
+            }
+            if (depth > 1) {
+                checked += verifyNode(position, depth - 1, line, mismatches, out);
+            }
+            line.pop_back();
+            position.unmakeMove(move, undo);
+        }
+        return checked;
+    }
+
+    // Entries are keyed by position and depth, so they stay valid from one
+    // root to the next and one table serves a whole run
+    std::unique_ptr<PerftHash> makeHash(const Perft::Options& options) {
+        return options.hashMegabytes > 0 ? std::make_unique<PerftHash>(options.hashMegabytes)
+            : nullptr;
+    }
+}  // namespace
+
+uint64_t Perft::perft(Position& position, int depth) {
+    return perftNode(position, depth, nullptr);
+}
+
+uint64_t Perft::perft(const Position& position, int depth, const Options& options) {
+    if (depth <= 0) return 1;
+    MoveList rootMoves{};
+    uint64_t nodes = 0;
+    const std::unique_ptr<PerftHash> hash = makeHash(options);
+    for (uint64_t count : countRootMoves(position, depth, options, hash.get(), rootMoves)) {
+        nodes += count;
+    }
+    return nodes;
+}
+
+uint64_t Perft::divide(const Position& position, int depth, const Options& options,
+    std::ostream& out) {
+    const auto start = std::chrono::steady_clock::now();
+
+    MoveList rootMoves{};
+    const std::unique_ptr<PerftHash> hash = makeHash(options);
+    const std::vector<uint64_t> counts =
+        countRootMoves(position, depth, options, hash.get(), rootMoves);
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        out << Utils::moveToStr(rootMoves[i]) << ": " << counts[i] << '\n';
+        nodes += counts[i];
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    out << "\nNodes: " << nodes << '\n'
+        << "Time (ms): " << static_cast<uint64_t>(elapsed.count() * 1000) << '\n'
+        << "Mnps: " << std::fixed << std::setprecision(2)
+        << millionsPerSecond(nodes, elapsed.count()) << '\n';
+    return nodes;
+}
+
+bool Perft::runSuite(int maxDepth, const Options& options, std::ostream& out) {
+    bool passed = true;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0.0;
+    const std::unique_ptr<PerftHash> hash = makeHash(options);
+
+    for (const SuiteEntry& entry : k_suite) {
+        Position position = Position::fromFen(entry.fen);
+        for (int depth = 1; depth <= maxDepth && depth <= 6; depth++) {
+            const uint64_t expected = entry.counts[depth - 1];
+            if (expected == 0) break;
+
+            const auto start = std::chrono::steady_clock::now();
+            MoveList rootMoves{};
+            uint64_t nodes = 0;
+            for (uint64_t count :
+                countRootMoves(position, depth, options, hash.get(), rootMoves)) {
+                nodes += count;
+            }
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            totalNodes += nodes;
+            totalSeconds += elapsed.count();
+
+            const bool ok = nodes == expected;
+            passed = passed && ok;
+            out << std::left << std::setw(20) << entry.name << std::right
+                << " depth " << depth << std::setw(12) << nodes
+                << (ok ? "  ok" : "  FAILED, expected ");
+            if (!ok) out << expected;
+            out << '\n';
+        }
+    }
+
+    out << "\nNodes: " << totalNodes << '\n'
+        << "Time (ms): " << static_cast<uint64_t>(totalSeconds * 1000) << '\n'
+        << "Mnps: " << std::fixed << std::setprecision(2)
+        << millionsPerSecond(totalNodes, totalSeconds) << '\n'
+        << (passed ? "All perft counts matched\n" : "Perft counts did not match\n");
+    return passed;
+}
+
+bool Perft::verifyChecks(const Position& position, int depth, std::ostream& out) {
+    Position copy{ position };
+    std::vector<Move> line{};
+    uint64_t mismatches = 0;
+    const uint64_t checked =
+        depth > 0 ? verifyNode(copy, depth, line, mismatches, out) : 0;
+
+    out << "Moves checked: " << checked << '\n'
+        << (mismatches == 0 ? "givesCheck matched every move\n"
+            : "givesCheck mismatches: " + std::to_string(mismatches) + '\n');
+    return mismatches == 0;
+}
+
+bool Perft::verifyChecksSuite(int maxDepth, std::ostream& out) {
+    bool passed = true;
+    for (const SuiteEntry& entry : k_suite) {
+        out << entry.name << " to depth " << maxDepth << '\n';
+        passed = verifyChecks(Position::fromFen(entry.fen), maxDepth, out) && passed;
+    }
+    out << '\n' << (passed ? "All givesCheck results matched\n"
+        : "givesCheck results did not match\n");
+    return passed;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+namespace Chess {
+    class Position;
+
+    namespace Perft {
+        struct Options {
+            int threads = 1;
+            // size of the shared perft hash, 0 disables it
+            size_t hashMegabytes = 64;
+        };
+
+        // Number of leaf nodes depth plies below position. The last ply is bulk
+        // counted with MoveGenerator::countLegal instead of being played.
+        uint64_t perft(Position& position, int depth);
+
+        // Same count, with subtrees split across a work stealing thread pool and
+        // transpositions deduplicated through a lock free hash keyed by
+        // Zobrist key and depth
+        uint64_t perft(const Position& position, int depth, const Options& options);
+
+        // Prints the leaf count below each root move and returns the total
+        uint64_t divide(const Position& position, int depth,
+            const Options& options = {}, std::ostream& out = std::cout);
+
+        // Runs the standard perft positions up to maxDepth and compares against
+        // the known counts. Returns whether every count matched.
+        bool runSuite(int maxDepth, const Options& options = {},
+            std::ostream& out = std::cout);
+
+        // Checks MoveGenerator::givesCheck against making the move and asking
+        // the child inCheck, for every legal move within depth plies of
+        // position. Prints the line to each disagreement and returns whether
+        // there were none.
+        bool verifyChecks(const Position& position, int depth,
+            std::ostream& out = std::cout);
+
+        // verifyChecks over the standard perft positions up to maxDepth
+        bool verifyChecksSuite(int maxDepth, std::ostream& out = std::cout);
+    }  // namespace Perft
+}
@@ -15,6 +15,10 @@ namespace Chess {
 
 	enum class PieceColor : uint8_t { White = 0, Black };
 
+	constexpr PieceColor oppositeColor(PieceColor color) {
+		return static_cast<PieceColor>(static_cast<uint8_t>(color) ^ 1);
+	}
+
 	struct Piece {
 		PieceType type = PieceType::Null;
 		PieceColor color = PieceColor::White;
@@ -1,60 +1,52 @@
 #pragma once
 
+#include <cstdint>
 
 #include "Piece.hpp"
+#include "Score.hpp"
+#include "TunedWeights.hpp"
 #include "DataStructures.hpp"
 
 namespace Chess {
     namespace PieceTables {
+        // Material by PieceType, Null included, for move ordering. The
+        // evaluation uses the tuned EvalWeights material instead.
+        inline constexpr Array<int, 7> pieceValues = { 100, 310, 300, 500, 800, 0, 0 };
+
+        // Non pawn material by PieceType. The sum over the board is the game
+        // phase, k_maxPhase with every piece on the board and 0 with only
+        // kings and pawns left.
+        inline constexpr Array<int, 7> phaseWeights = { 0, 1, 1, 2, 4, 0, 0 };
+        inline constexpr int k_maxPhase = 24;
+
+        // piece square tables are written from white's side with a8 first
+        constexpr uint8_t relativeSquare(PieceColor color, uint8_t square) {
+            return color == PieceColor::White ? square : square ^ 56;
+        }
+
+        constexpr Array3D<Score, 6, 2, 64> genWhiteScores() {
+            const EvalWeights::Weights& weights = EvalWeights::weights;
+            Array3D<Score, 6, 2, 64> scores{};
+            for (uint8_t type = 0; type < 6; type++) {
+                for (uint8_t square = 0; square < 64; square++) {
+                    for (const PieceColor color : { PieceColor::White, PieceColor::Black }) {
+                        const Score score = weights.material[type] +
+                            weights.pieceSquares[type][relativeSquare(color, square)];
+                        scores[type][static_cast<uint8_t>(color)][square] =
+                            color == PieceColor::White ? score : -score;
+                    }
+                }
+            }
+            return scores;
+        }
+
+        // Material plus table values of a piece for both phases, negated for
+        // black, so the score of a position from white's side is the plain
+        // sum over its pieces
+        inline constexpr Array3D<Score, 6, 2, 64> whiteScores = genWhiteScores();
 
-        constexpr Array<int, 64> pawnTable = {
-            0,  0,  0,  0,   0,   0,  0,  0,  50, 50, 50,  50, 50, 50,  50, 50,
-            10, 10, 20, 30,  30,  20, 10, 10, 5,  5,  10,  25, 25, 10,  5,  5,
-            0,  0,  0,  20,  20,  0,  0,  0,  5,  -5, -10, 0,  0,  -10, -5, 5,
-            5,  10, 10, -20, -20, 10, 10, 5,  0,  0,  0,   0,  0,  0,   0,  0 };
-
-        constexpr Array<int, 64> knightTable = {
-            -50, -40, -30, -30, -30, -30, -40, -50, -40, -20, 0,   0,   0,
-            0,   -20, -40, -30, 0,   10,  15,  15,  10,  0,   -30, -30, 5,
-            15,  20,  20,  15,  5,   -30, -30, 0,   15,  20,  20,  15,  0,
-            -30, -30, 5,   10,  15,  15,  10,  5,   -30, -40, -20, 0,   5,
-            5,   0,   -20, -40, -50, -40, -30, -30, -30, -30, -40, -50 };
-
-        constexpr Array<int, 64> bishopTable = {
-            -20, -10, -10, -10, -10, -10, -10, -20, -10, 0,   0,   0,   0,
-            0,   0,   -10, -10, 0,   5,   10,  10,  5,   0,   -10, -10, 5,
-            5,   10,  10,  5,   5,   -10, -10, 0,   10,  10,  10,  10,  0,
-            -10, -10, 10,  10,  10,  10,  10,  10,  -10, -10, 5,   0,   0,
-            0,   0,   5,   -10, -20, -10, -10, -10, -10, -10, -10, -20 };
-
-        constexpr Array<int, 64> rookTable = { 0,  0,  0, 0,  0, 0,  0,  0, 5,  10, 10, 10, 10,
-                                       10, 10, 5, -5, 0, 0,  0,  0, 0,  0,  -5, -5, 0,
-                                       0,  0,  0, 0,  0, -5, -5, 0, 0,  0,  0,  0,  0,
-                                       -5, -5, 0, 0,  0, 0,  0,  0, -5, -5, 0,  0,  0,
-                                       0,  0,  0, -5, 0, 0,  0,  5, 5,  0,  0,  0 };
-
-        constexpr Array<int, 64> queenTable = {
-            -20, -10, -10, -5, -5, -10, -10, -20, -10, 0,   0,   0,  0,  0,   0,   -10,
-            -10, 0,   5,   5,  5,  5,   0,   -10, -5,  0,   5,   5,  5,  5,   0,   -5,
-            0,   0,   5,   5,  5,  5,   0,   -5,  -10, 5,   5,   5,  5,  5,   0,   -10,
-            -10, 0,   5,   0,  0,  0,   0,   -10, -20, -10, -10, -5, -5, -10, -10, -20 };
-
-        constexpr Array<int, 64> kingTable = {
-            -30, -40, -40, -50, -50, -40, -40, -30, -30, -40, -40, -50, -50,
-            -40, -40, -30, -30, -40, -40, -50, -50, -40, -40, -30, -30, -40,
-            -40, -50, -50, -40, -40, -30, -20, -30, -30, -40, -40, -30, -30,
-            -20, -10, -20, -20, -20, -20, -20, -20, -10, 20,  20,  0,   0,
-            0,   0,   20,  20,  20,  30,  10,  0,   0,   10,  30,  20 };
-
-        inline const Array<const Array<int, 64>*, 6> tables = { &pawnTable, &bishopTable, &knightTable,
-                                      &rookTable, &queenTable, &kingTable };
-
-        int getValue(PieceType type, PieceColor color, uint8_t square) {
-            const Array<int, 64>& table = *tables[static_cast<uint8_t>(type)];
-            const int value = color == PieceColor::White
-                ? table[square]
-                : table[(7 - (square / 8)) * 8 + square % 8];
-            return value;
+        constexpr Score getWhiteScore(PieceType type, PieceColor color, uint8_t square) {
+            return whiteScores[static_cast<uint8_t>(type)][static_cast<uint8_t>(color)][square];
         }
-    }; 
-}
\ No newline at end of file
+    };
+}
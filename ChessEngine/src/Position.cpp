@@ -7,14 +7,19 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "MoveGenerator.hpp"
+#include "PieceTables.hpp"
 #include "Utils.hpp"
 #include "SquareAliases.hpp"
 
 using namespace Chess;
 
+static_assert(std::is_trivially_copyable_v<Position>);
+
 Position Position::fromFen(std::string_view fen) {
     static const std::unordered_map<char, PieceType> pieceMapping{
         {'p', PieceType::Pawn},   {'b', PieceType::Bishop},
@@ -99,34 +104,25 @@ Position Position::fromFen(std::string_view fen) {
     position.m_state.hash = Zobrist::fromPosition(
         position);  // the hash was already partially computed as a side
     // effect of this function but who cares
+    position.m_state.pawnHash = Zobrist::pawnsFromPosition(position);
     return position;
 }
 
-Position Position::defaultPosition() {
-    return Position::fromFen(
-        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+void Position::attachAccumulator(Nnue::Accumulator* accumulator) {
+    m_accumulator = Nnue::isLoaded() ? accumulator : nullptr;
+    if (m_accumulator) {
+        Nnue::refresh(*m_accumulator, *this);
+    }
 }
 
-void Position::setCastleKingside(bool flag) {
-    const uint8_t mask =
-        (m_turn == PieceColor::White) ? WhiteCastleKingside : BlackCastleKingside;
-    if (flag) {
-        m_state.castlingFlags |= mask;
-    }
-    else {
-        m_state.castlingFlags &= ~mask;
-    }
+void Position::copyAccumulatorTo(Nnue::Accumulator& target) {
+    target = *m_accumulator;
+    m_accumulator = &target;
 }
 
-void Position::setCastleQueenside(bool flag) {
-    const uint8_t mask = (m_turn == PieceColor::White) ? WhiteCastleQueenside
-        : BlackCastleQueenside;
-    if (flag) {
-        m_state.castlingFlags |= mask;
-    }
-    else {
-        m_state.castlingFlags &= ~mask;
-    }
+Position Position::defaultPosition() {
+    return Position::fromFen(
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 }
 
 bool Position::canCastleKingside() const {
@@ -146,11 +142,19 @@ void Position::addPiece(PieceType piece, PieceColor color, uint8_t square) {
         square);
     m_colorBitboards[static_cast<uint8_t>(color)].setBit(square);
     m_pieces[square] = Piece{ piece, color };
+    m_whiteScore += PieceTables::getWhiteScore(piece, color, square);
+    m_phase += PieceTables::phaseWeights[static_cast<uint8_t>(piece)];
+    if (m_accumulator) {
+        Nnue::addPiece(*m_accumulator, piece, color, square);
+    }
 }
 
 void Position::addPieceAndUpdateZobrist(PieceType piece, PieceColor color, uint8_t square) {
     addPiece(piece, color, square);
     m_state.hash.togglePiece(piece, color, square);
+    if (piece == PieceType::Pawn) {
+        m_state.pawnHash.togglePiece(piece, color, square);
+    }
 }
 
 void Position::removePiece(PieceType piece, PieceColor color, uint8_t square) {
@@ -158,11 +162,19 @@ void Position::removePiece(PieceType piece, PieceColor color, uint8_t square) {
         .clearBit(square);
     m_colorBitboards[static_cast<uint8_t>(color)].clearBit(square);
     m_pieces[square] = Piece{};
+    m_whiteScore -= PieceTables::getWhiteScore(piece, color, square);
+    m_phase -= PieceTables::phaseWeights[static_cast<uint8_t>(piece)];
+    if (m_accumulator) {
+        Nnue::removePiece(*m_accumulator, piece, color, square);
+    }
 }
 
 void Position::removePieceAndUpdateZobrist(PieceType piece, PieceColor color, uint8_t square) {
     removePiece(piece, color, square);
     m_state.hash.togglePiece(piece, color, square);
+    if (piece == PieceType::Pawn) {
+        m_state.pawnHash.togglePiece(piece, color, square);
+    }
 }
 
 void Position::movePiece(PieceType piece, PieceColor color, uint8_t src,
@@ -175,133 +187,172 @@ void Position::movePiece(PieceType piece, PieceColor color, uint8_t src,
     colorBB.setBit(dst);
     m_pieces[src] = Piece{};
     m_pieces[dst] = Piece{ piece, color };
+    m_whiteScore += PieceTables::getWhiteScore(piece, color, dst) -
+        PieceTables::getWhiteScore(piece, color, src);
+    if (m_accumulator) {
+        Nnue::movePiece(*m_accumulator, piece, color, src, dst);
+    }
 }
 
 void Position::movePieceAndUpdateZobrist(PieceType piece, PieceColor color, uint8_t src, uint8_t dst) {
-    Bitboard& bb = m_bitboards[static_cast<uint8_t>(piece)][static_cast<uint8_t>(color)];
-    Bitboard& colorBB = m_colorBitboards[static_cast<uint8_t>(color)];
-    bb.clearBit(src);
-    bb.setBit(dst);
-    colorBB.clearBit(src);
-    colorBB.setBit(dst);
-    m_pieces[src] = Piece{};
-    m_pieces[dst] = Piece{ piece, color };
+    movePiece(piece, color, src, dst);
     m_state.hash.togglePiece(piece, color, src);
     m_state.hash.togglePiece(piece, color, dst);
+    if (piece == PieceType::Pawn) {
+        m_state.pawnHash.togglePiece(piece, color, src);
+        m_state.pawnHash.togglePiece(piece, color, dst);
+    }
+}
+
+void Position::computeCheckInfo() const {
+    m_checkInfo = MoveGenerator::computeCheckInfo(*this);
+    m_hasCheckInfo = true;
+}
+
+void Position::computeCheckingSquares() const {
+    m_checkingSquares = MoveGenerator::computeCheckingSquares(*this);
+    m_hasCheckingSquares = true;
 }
 
-void Position::makeMove(Move move) {
-    const Piece toMove = m_pieces[move.start];
-    const Piece captured = m_pieces[move.target];
-    m_positionHistory.push({.state = m_state, .captured = captured});
+void Position::makeMove(Move move, UndoState& undo) {
+    m_hasCheckInfo = false;
+    m_hasCheckingSquares = false;
+    if (m_turn == PieceColor::White) {
+        makeMoveImpl<PieceColor::White>(move, undo);
+    }
+    else {
+        makeMoveImpl<PieceColor::Black>(move, undo);
+    }
+}
+
+void Position::unmakeMove(Move move, const UndoState& undo) {
+    m_hasCheckInfo = false;
+    m_hasCheckingSquares = false;
+    // the side that made the move is the one not on turn now
+    if (m_turn == PieceColor::Black) {
+        unmakeMoveImpl<PieceColor::White>(move, undo);
+    }
+    else {
+        unmakeMoveImpl<PieceColor::Black>(move, undo);
+    }
+}
+
+template <PieceColor Us>
+void Position::makeMoveImpl(Move move, UndoState& undo) {
+    constexpr PieceColor them = oppositeColor(Us);
+    // square behind a pawn from our point of view
+    constexpr int behind = Us == PieceColor::White ? 8 : -8;
+    constexpr uint8_t castlingRights = Us == PieceColor::White
+        ? (WhiteCastleKingside | WhiteCastleQueenside)
+        : (BlackCastleKingside | BlackCastleQueenside);
+
+    const uint8_t start = move.start();
+    const uint8_t target = move.target();
+    const Piece toMove = m_pieces[start];
+    // empty for en passant, the captured pawn is not on the target square
+    const Piece captured = m_pieces[target];
+    undo = { .state = m_state, .captured = captured };
 
-    m_ply++;
     m_state.halfMoveClock++;
     
     m_state.hash.toggleCastlingFlags(m_state.castlingFlags);
 
     if (captured) {
-        removePieceAndUpdateZobrist(captured.type, captured.color, move.target);
+        removePieceAndUpdateZobrist(captured.type, them, target);
     }
-    if (captured || toMove.type == PieceType::Pawn) {
+    if (move.isCapture() || toMove.type == PieceType::Pawn) {
         m_state.halfMoveClock = 0;
     }
 
-    movePieceAndUpdateZobrist(toMove.type, toMove.color, move.start, move.target);
-
-    // kingside castle
-    if (toMove.type == PieceType::King) {
-        if (move.target - move.start == 2) {
-            movePieceAndUpdateZobrist(PieceType::Rook, m_turn, move.start + 3, move.start + 1);
-        }
-        if (move.start - move.target == 2) {
-            movePieceAndUpdateZobrist(PieceType::Rook, m_turn, move.start - 4, move.start - 1);
-        }
-        setCastleKingside(false);
-        setCastleQueenside(false);
-    }
-
-    if (toMove.type == PieceType::Pawn && move.target == m_state.enPassantTarget) {
-        removePieceAndUpdateZobrist(PieceType::Pawn, getOppositeTurn(),
-            m_state.enPassantTarget + (m_turn == PieceColor::White ? 8 : -8));
-    }
-
     if (m_state.enPassantTarget != invalidSquare) {
         m_state.hash.toggleEnPassantFile(m_state.enPassantTarget % 8);
-    }
-    // set en passant square
-    if (toMove.type == PieceType::Pawn && abs(move.start - move.target) == 16) {
-        m_state.hash.toggleEnPassantFile(move.start % 8);
-        m_state.enPassantTarget = move.start + (m_turn == PieceColor::White ? -8 : 8);
-    }
-    else {
         m_state.enPassantTarget = invalidSquare;
     }
 
-    // handle promotion
-    if (move.promotion != PieceType::Null) {
-        removePieceAndUpdateZobrist(PieceType::Pawn, m_turn, move.target);
-        addPieceAndUpdateZobrist(move.promotion, m_turn, move.target);
+    switch (move.flag()) {
+    case MoveFlag::DoublePush:
+        movePieceAndUpdateZobrist(PieceType::Pawn, Us, start, target);
+        m_state.hash.toggleEnPassantFile(start % 8);
+        m_state.enPassantTarget = start - behind;
+        break;
+    case MoveFlag::KingCastle:
+        movePieceAndUpdateZobrist(PieceType::King, Us, start, target);
+        movePieceAndUpdateZobrist(PieceType::Rook, Us, start + 3, start + 1);
+        break;
+    case MoveFlag::QueenCastle:
+        movePieceAndUpdateZobrist(PieceType::King, Us, start, target);
+        movePieceAndUpdateZobrist(PieceType::Rook, Us, start - 4, start - 1);
+        break;
+    case MoveFlag::EnPassant:
+        movePieceAndUpdateZobrist(PieceType::Pawn, Us, start, target);
+        removePieceAndUpdateZobrist(PieceType::Pawn, them, target + behind);
+        break;
+    default:
+        if (move.isPromotion()) {
+            removePieceAndUpdateZobrist(PieceType::Pawn, Us, start);
+            addPieceAndUpdateZobrist(move.promotion(), Us, target);
+        }
+        else {
+            movePieceAndUpdateZobrist(toMove.type, Us, start, target);
+        }
+        break;
     }
 
+    if (toMove.type == PieceType::King) {
+        m_state.castlingFlags &= ~castlingRights;
+    }
     // update castling flags for moving or capturing rook
-    if (move.start == Square::h1 || move.target == Square::h1) {
+    if (start == Square::h1 || target == Square::h1) {
         m_state.castlingFlags &= ~WhiteCastleKingside;
     }
-    if (move.start == Square::a1 || move.target == Square::a1) {
+    if (start == Square::a1 || target == Square::a1) {
         m_state.castlingFlags &= ~WhiteCastleQueenside;
     }
-    if (move.start == Square::h8 || move.target == Square::h8) {
+    if (start == Square::h8 || target == Square::h8) {
         m_state.castlingFlags &= ~BlackCastleKingside;
     }
-    if (move.start == Square::a8 || move.target == Square::a8) {
+    if (start == Square::a8 || target == Square::a8) {
         m_state.castlingFlags &= ~BlackCastleQueenside;
     }
     m_state.hash.toggleCastlingFlags(m_state.castlingFlags);
     m_state.hash.toggleSide();
-    m_turn = getOppositeTurn();
+    m_turn = them;
 }
 
-void Position::unmakeMove(Move move) {
-    const UndoState undoState = m_positionHistory.top();
-    const Piece captured = undoState.captured;
-    m_state = undoState.state;
-    m_positionHistory.pop();
-    m_turn = getOppositeTurn();
-    m_ply--;
-
-    const Piece moved = m_pieces[move.target];
-    const PieceType movedType = move.promotion == PieceType::Null ? moved.type : PieceType::Pawn;
-
-    addPiece(movedType, moved.color, move.start);
-    removePiece(moved.type, moved.color, move.target);
-    if (captured) addPiece(captured.type, captured.color, move.target);
-    
-    if (move.target == m_state.enPassantTarget && movedType == PieceType::Pawn) {
-        const int offset = moved.color == PieceColor::White ? 8 : -8;
-        addPiece(PieceType::Pawn, getOppositeTurn(), m_state.enPassantTarget + offset);
-    }
-
-    if (moved.type == PieceType::King) {
-        // Undo kingside castle
-        if (move.target - move.start == 2) {
-            movePiece(PieceType::Rook, m_turn, move.start + 1, move.start + 3);
-        }
-        // Undo queenside castle
-        else if (move.start - move.target == 2) {
-            movePiece(PieceType::Rook, m_turn, move.start - 1, move.start - 4);
+template <PieceColor Us>
+void Position::unmakeMoveImpl(Move move, const UndoState& undo) {
+    constexpr PieceColor them = oppositeColor(Us);
+    constexpr int behind = Us == PieceColor::White ? 8 : -8;
+
+    const Piece captured = undo.captured;
+    m_state = undo.state;
+    m_turn = Us;
+
+    const uint8_t start = move.start();
+    const uint8_t target = move.target();
+
+    switch (move.flag()) {
+    case MoveFlag::KingCastle:
+        movePiece(PieceType::King, Us, target, start);
+        movePiece(PieceType::Rook, Us, start + 1, start + 3);
+        break;
+    case MoveFlag::QueenCastle:
+        movePiece(PieceType::King, Us, target, start);
+        movePiece(PieceType::Rook, Us, start - 1, start - 4);
+        break;
+    case MoveFlag::EnPassant:
+        movePiece(PieceType::Pawn, Us, target, start);
+        addPiece(PieceType::Pawn, them, target + behind);
+        break;
+    default:
+        if (move.isPromotion()) {
+            removePiece(move.promotion(), Us, target);
+            addPiece(PieceType::Pawn, Us, start);
         }
-    }
-}
-
-bool Position::hasRepeatedThreefold() const {
-    int startPly = m_ply - m_state.halfMoveClock - 1;
-    if (startPly < 0) startPly = 0;
-    int repetitionCount = 1;
-    for (int i = m_positionHistory.size() - 2; i >= startPly; i -= 2) {
-        if (m_positionHistory[i].state.hash == m_state.hash) {
-            repetitionCount++;
+        else {
+            movePiece(m_pieces[target].type, Us, target, start);
         }
+        if (captured) addPiece(captured.type, them, target);
+        break;
     }
-    return repetitionCount >= 3;
 }
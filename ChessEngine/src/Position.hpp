@@ -5,14 +5,60 @@
 
 #include "Bitboard.hpp"
 #include "Move.hpp"
+#include "Nnue.hpp"
 #include "Piece.hpp"
+#include "Score.hpp"
 #include "Zobrist.hpp"
 #include "DataStructures.hpp"
 
 namespace Chess {
+    // Attack information for the side to move, shared by everything that
+    // needs to know about checks and pins in a position
+    struct CheckInfo {
+        // enemy pieces giving check
+        Bitboard checkers{};
+        // friendly pieces pinned to the king
+        Bitboard pinned{};
+        // squares attacked by the enemy, seen through our king
+        Bitboard dangers{};
+        // squares a non king move must land on: everything when not in check,
+        // the checker or the ray to it in single check, nothing in double check
+        Bitboard checkMask{};
+    };
+
+    // What it takes for the side to move to give check, see
+    // MoveGenerator::givesCheck
+    struct CheckingSquares {
+        // squares a piece of each type would attack the enemy king from
+        Array<Bitboard, 6> squares{};
+        // friendly pieces that uncover a check by a friendly slider when
+        // they leave the line to the enemy king
+        Bitboard discoverers{};
+    };
+
+    // A plain board that is cheap to copy. What unmakeMove needs is handed
+    // back to the caller, and the positions a game went through are kept by
+    // GameHistory.
     class Position {
     public:
         static constexpr uint8_t invalidSquare = 0xFF;
+
+    private:
+        struct State {
+            uint8_t castlingFlags{};
+            uint8_t enPassantTarget{ invalidSquare };
+            uint8_t halfMoveClock{};
+            Zobrist hash{};
+            Zobrist pawnHash{};
+        };
+
+    public:
+        // filled in by makeMove, only meaningful to the matching unmakeMove
+        struct UndoState {
+            State state{};
+            Piece captured{};
+        };
+
         static Position fromFen(std::string_view fen);
         static Position defaultPosition();
 
@@ -20,6 +66,9 @@ namespace Chess {
             return m_bitboards[static_cast<uint8_t>(piece)]
                 [static_cast<uint8_t>(color)];
         }
+        inline Bitboard getColorBitboard(PieceColor color) const {
+            return m_colorBitboards[static_cast<uint8_t>(color)];
+        }
         inline Bitboard getFriendlyBitboard() const {
             return m_colorBitboards[static_cast<uint8_t>(m_turn)];
         }
@@ -120,14 +169,55 @@ namespace Chess {
 
         inline Zobrist getZobrist() const { return m_state.hash; }
 
+        // covers the pawns only, changes on pawn moves, captures and promotions
+        inline Zobrist getPawnZobrist() const { return m_state.pawnHash; }
+
+        // material plus piece square tables from white's side for both game
+        // phases, kept up to date by every piece added, removed or moved
+        inline Score getWhiteScore() const { return m_whiteScore; }
+
+        // sum of PieceTables::phaseWeights over the board, can exceed
+        // PieceTables::k_maxPhase after promotions
+        inline int getPhase() const { return m_phase; }
+
+        // Points the position at a network accumulator owned by the caller,
+        // recomputes it from the board and keeps it up to date through every
+        // make and unmake. Copies share the accumulator. Detaches it when
+        // accumulator is nullptr or no network is loaded.
+        void attachAccumulator(Nnue::Accumulator* accumulator);
+        // copies the attached accumulator into target and switches to it, so
+        // a copy of the position can make moves of its own
+        void copyAccumulatorTo(Nnue::Accumulator& target);
+        inline bool usesNnue() const { return m_accumulator != nullptr; }
+        inline const Nnue::Accumulator& getAccumulator() const { return *m_accumulator; }
+
+        // plies since the last capture or pawn move
+        inline uint8_t getHalfMoveClock() const { return m_state.halfMoveClock; }
+
         bool canCastleKingside() const;
         bool canCastleQueenside() const;
         inline Piece getPieceAt(uint8_t square) const { return m_pieces[square]; }
 
-        void makeMove(Move move);
-        void unmakeMove(Move move);
+        // computed on first use and kept until the next make or unmake
+        inline const CheckInfo& getCheckInfo() const {
+            if (!m_hasCheckInfo) {
+                computeCheckInfo();
+            }
+            return m_checkInfo;
+        }
+
+        inline bool inCheck() const { return getCheckInfo().checkers; }
 
-        bool hasRepeatedThreefold() const;
+        // computed on first use like the check info
+        inline const CheckingSquares& getCheckingSquares() const {
+            if (!m_hasCheckingSquares) {
+                computeCheckingSquares();
+            }
+            return m_checkingSquares;
+        }
+
+        void makeMove(Move move, UndoState& undo);
+        void unmakeMove(Move move, const UndoState& undo);
 
     private:
         enum CastlingFlag : uint8_t {
@@ -137,18 +227,6 @@ namespace Chess {
             BlackCastleQueenside = 0b1000
         };
 
-        struct State {
-            uint8_t castlingFlags{};
-            uint8_t enPassantTarget{ invalidSquare };
-            uint8_t halfMoveClock{};
-            Zobrist hash{};
-        };
-
-        struct UndoState {
-            State state{};
-            Piece captured{};
-        };
-
         Array2D<Bitboard, 6, 2> m_bitboards{};
         Array<Bitboard, 2> m_colorBitboards{};
 
@@ -158,9 +236,19 @@ namespace Chess {
 
         State m_state{};
 
-        int m_ply{ 0 };
+        Score m_whiteScore{};
+        int m_phase{ 0 };
+
+        // kept outside so copying a position stays cheap, see attachAccumulator
+        Nnue::Accumulator* m_accumulator{ nullptr };
+
+        mutable CheckInfo m_checkInfo{};
+        mutable bool m_hasCheckInfo{ false };
+        mutable CheckingSquares m_checkingSquares{};
+        mutable bool m_hasCheckingSquares{ false };
 
-        FixedStack<UndoState, 1024> m_positionHistory{};
+        void computeCheckInfo() const;
+        void computeCheckingSquares() const;
 
         void addPiece(PieceType type, PieceColor color, uint8_t square);
         void addPieceAndUpdateZobrist(PieceType type, PieceColor color, uint8_t square);
@@ -169,7 +257,8 @@ namespace Chess {
         void movePiece(PieceType type, PieceColor color, uint8_t src, uint8_t dst);
         void movePieceAndUpdateZobrist(PieceType type, PieceColor color, uint8_t src, uint8_t dst);
 
-        void setCastleKingside(bool flag);
-        void setCastleQueenside(bool flag);
+        // makeMove and unmakeMove dispatch once on the side to move
+        template <PieceColor Us> void makeMoveImpl(Move move, UndoState& undo);
+        template <PieceColor Us> void unmakeMoveImpl(Move move, const UndoState& undo);
     };
 }
\ No newline at end of file
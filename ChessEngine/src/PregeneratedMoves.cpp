@@ -1,46 +1,69 @@
 #include "PregeneratedMoves.hpp"
 
-#include <unordered_set>
-#include <vector>
+#include <bit>
 
+#include "Cpu.hpp"
 #include "MagicData.hpp"
 #include "Utils.hpp"
 #include "DataStructures.hpp"
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define CHESS_PEXT_AVAILABLE
+#if defined(__GNUC__) || defined(__clang__)
+// only these functions may use BMI2, everything else must run on any x86-64
+#define CHESS_TARGET_BMI2 __attribute__((target("bmi2")))
+#else
+#define CHESS_TARGET_BMI2
+#endif
+#endif
+
 using namespace Chess;
 
 namespace {
-    Array<Bitboard, 64> knightMoves{};
-    Array<Bitboard, 64> kingMoves{};
-    Array2D<Bitboard, 64, 512> bishopMoves{};
-    Array2D<Bitboard, 64, 4096> rookMoves{};
-    // ray from i -> j, not inclusive of i
-    Array2D<Bitboard, 64, 64> between{};
-    // ray from i through j to end of board, not inclusive of i
-    Array2D<Bitboard, 64, 64> lines{};
+    // squares reached from each square in each sliding direction on an empty board
+    constexpr Array2D<uint64_t, 8, 64> genRays() {
+        Array2D<uint64_t, 8, 64> rays{};
+        for (uint8_t dirIndex = 0; dirIndex < 8; dirIndex++) {
+            const Utils::Coordinate dcoord = Utils::slidingDirections[dirIndex];
+            for (uint8_t square = 0; square < 64; square++) {
+                auto coord = Utils::Coordinate::fromSquare(square) + dcoord;
+                while (coord.inBounds()) {
+                    rays[dirIndex][square] |= 1ULL << coord.toSquare();
+                    coord += dcoord;
+                }
+            }
+        }
+        return rays;
+    }
 
-    Bitboard getSlidingMoves(uint8_t square, Bitboard blockers, bool rook) {
-        Bitboard moves{};
+    constexpr Array2D<uint64_t, 8, 64> emptyBoardRays = genRays();
+
+    // A ray is cut off behind the nearest blocker, which is the lowest set
+    // bit for directions of increasing square index and the highest otherwise.
+    // Works on raw words so filling every slider table stays cheap enough
+    // to do during compilation.
+    constexpr uint64_t getSlidingMoves(uint8_t square, uint64_t blockers, bool rook) {
+        uint64_t moves = 0;
         const uint8_t start = rook ? 0 : 4;
         const uint8_t end = rook ? 3 : 7;
 
         for (uint8_t dirIndex = start; dirIndex <= end; dirIndex++) {
-            const Utils::Coordinate dcoord = Utils::slidingDirections[dirIndex];
-            auto coord = Utils::Coordinate::fromSquare(square) + dcoord;
-
-            while (coord.inBounds()) {
-                const auto board = Bitboard::fromSquare(coord.toSquare());
-                moves |= board;
-                if (board & blockers) {
-                    break;
-                }
-                coord += dcoord;
+            const uint64_t ray = emptyBoardRays[dirIndex][square];
+            const uint64_t hit = ray & blockers;
+            if (!hit) {
+                moves |= ray;
+                continue;
             }
+            const Utils::Coordinate dcoord = Utils::slidingDirections[dirIndex];
+            const int blocker = dcoord.row * 8 + dcoord.col > 0 ?
+                std::countr_zero(hit) : 63 - std::countl_zero(hit);
+            moves |= ray & ~emptyBoardRays[dirIndex][blocker];
         }
         return moves;
     }
 
-    Bitboard genKnightMoves(uint8_t square) {
+    constexpr Bitboard genKnightMoves(uint8_t square) {
         Bitboard moves{};
 
         for (uint8_t dirIndex = 0; dirIndex < 8; dirIndex++) {
@@ -54,7 +77,7 @@ namespace {
         return moves;
     }
 
-    Bitboard genKingMoves(uint8_t square) {
+    constexpr Bitboard genKingMoves(uint8_t square) {
         Bitboard moves{};
 
         for (uint8_t dirIndex = 0; dirIndex < 8; dirIndex++) {
@@ -68,7 +91,7 @@ namespace {
         return moves;
     }
 
-    void setBetween(uint8_t square) {
+    constexpr void setBetween(Array2D<Bitboard, 64, 64>& between, uint8_t square) {
         for (uint8_t dirIndex = 0; dirIndex < 8; dirIndex++) {
             const Utils::Coordinate dcoord = Utils::slidingDirections[dirIndex];
             Utils::Coordinate coord = Utils::Coordinate::fromSquare(square) + dcoord;
@@ -81,47 +104,143 @@ namespace {
         }
     }
 
-    void setLine(uint8_t square) {
+    constexpr void setLine(Array2D<Bitboard, 64, 64>& lines, uint8_t square) {
         for (uint8_t dirIndex = 0; dirIndex < 8; dirIndex++) {
             const Utils::Coordinate dcoord = Utils::slidingDirections[dirIndex];
-            Utils::Coordinate coord = Utils::Coordinate::fromSquare(square) + dcoord;
             Bitboard board = Bitboard::fromSquare(square);
-            std::unordered_set<uint8_t> visited{};
+            Bitboard visited{};
+            Utils::Coordinate coord = Utils::Coordinate::fromSquare(square) + dcoord;
             while (coord.inBounds()) {
-                board.setBit(coord.toSquare());
-                visited.insert(coord.toSquare());
+                visited.setBit(coord.toSquare());
                 coord += dcoord;
             }
             coord = Utils::Coordinate::fromSquare(square) - dcoord;
             while (coord.inBounds()) {
-                board.setBit(coord.toSquare());
-                visited.insert(coord.toSquare());
+                visited.setBit(coord.toSquare());
                 coord -= dcoord;
             }
-            for (uint8_t dst : visited) {
-                lines[square][dst] = board;
+            board |= visited;
+            while (visited) {
+                lines[square][visited.popLSB()] = board;
             }
         }
     }
 
-    uint64_t magicIndex(const MagicEntry& magicEntry, Bitboard blockers) {
+    constexpr uint64_t magicIndex(const MagicEntry& magicEntry, Bitboard blockers) {
         return (blockers * magicEntry.magic) >> (magicEntry.shifts);
     }
 
+    constexpr Array<Bitboard, 64> genLeaperTable(Bitboard(*gen)(uint8_t)) {
+        Array<Bitboard, 64> table{};
+        for (uint8_t square = 0; square < 64; square++) {
+            table[square] = gen(square);
+        }
+        return table;
+    }
+
+    constexpr Array2D<Bitboard, 64, 64> genBetweenTable() {
+        Array2D<Bitboard, 64, 64> table{};
+        for (uint8_t square = 0; square < 64; square++) {
+            setBetween(table, square);
+        }
+        return table;
+    }
+
+    constexpr Array2D<Bitboard, 64, 64> genLineTable() {
+        Array2D<Bitboard, 64, 64> table{};
+        for (uint8_t square = 0; square < 64; square++) {
+            setLine(table, square);
+        }
+        return table;
+    }
+
+    // Every square's attacks packed at its MagicEntry offset, indexed by the
+    // magic multiply when pext is false and by PEXT of the mask otherwise
+    constexpr Array<uint64_t, MagicData::sliderTableSize> genSliderTable(bool pext) {
+        Array<uint64_t, MagicData::sliderTableSize> table{};
+        for (uint8_t square = 0; square < 64; square++) {
+            for (const bool rook : { true, false }) {
+                const MagicEntry& entry = rook ? MagicData::rookMagics[square] :
+                    MagicData::bishopMagics[square];
+                // carry rippler, visits the subsets of the mask in the same
+                // order as their PEXT indices
+                const uint64_t mask = entry.mask.get();
+                uint64_t blockers = 0;
+                for (uint64_t i = 0; i < (1ULL << entry.mask.numBits()); i++) {
+                    const uint64_t index = pext ? i : magicIndex(entry, Bitboard{ blockers });
+                    table[entry.offset + index] = getSlidingMoves(square, blockers, rook);
+                    blockers = (blockers - mask) & mask;
+                }
+            }
+        }
+        return table;
+    }
+
+    // All tables are built at compile time, so they sit in read only data,
+    // are shared between processes and need no initialization
+    constexpr Array<Bitboard, 64> knightMoves = genLeaperTable(genKnightMoves);
+    constexpr Array<Bitboard, 64> kingMoves = genLeaperTable(genKingMoves);
+    // ray from i -> j, not inclusive of i
+    constexpr Array2D<Bitboard, 64, 64> between = genBetweenTable();
+    // ray from i through j to end of board, not inclusive of i
+    constexpr Array2D<Bitboard, 64, 64> lines = genLineTable();
+    // Rook and bishop attacks for every square packed back to back, about
+    // 840KB per table instead of 2.25MB of fixed 4096 and 512 entry rows.
+    // Only the table matching the active indexing is ever touched.
+    alignas(64) constexpr Array<uint64_t, MagicData::sliderTableSize> magicSliderMoves =
+        genSliderTable(false);
+#ifdef CHESS_PEXT_AVAILABLE
+    alignas(64) constexpr Array<uint64_t, MagicData::sliderTableSize> pextSliderMoves =
+        genSliderTable(true);
+#endif
+
+    Bitboard rookMovesMagic(uint8_t square, Bitboard occupied) {
+        const MagicEntry& entry = MagicData::rookMagics[square];
+        return Bitboard{ magicSliderMoves[entry.offset + magicIndex(entry, occupied & entry.mask)] };
+    }
+
+    Bitboard bishopMovesMagic(uint8_t square, Bitboard occupied) {
+        const MagicEntry& entry = MagicData::bishopMagics[square];
+        return Bitboard{ magicSliderMoves[entry.offset + magicIndex(entry, occupied & entry.mask)] };
+    }
+
+#ifdef CHESS_PEXT_AVAILABLE
+    CHESS_TARGET_BMI2 Bitboard rookMovesPext(uint8_t square, Bitboard occupied) {
+        const MagicEntry& entry = MagicData::rookMagics[square];
+        return Bitboard{ pextSliderMoves[entry.offset + _pext_u64(occupied.get(), entry.mask.get())] };
+    }
+
+    CHESS_TARGET_BMI2 Bitboard bishopMovesPext(uint8_t square, Bitboard occupied) {
+        const MagicEntry& entry = MagicData::bishopMagics[square];
+        return Bitboard{ pextSliderMoves[entry.offset + _pext_u64(occupied.get(), entry.mask.get())] };
+    }
+#endif
+
+    PregeneratedMoves::SliderIndexing sliderIndexing =
+        PregeneratedMoves::SliderIndexing::Magic;
+    // Set once by init and never changed during a search, so the branch on
+    // it is always predicted. The magic lookup inlines into the branch, and
+    // the BMI2 lookup, which cannot inline into code built for any x86-64,
+    // is a direct call.
+    bool usePext = false;
 }  // namespace
 
 Bitboard PregeneratedMoves::getRookMoves(uint8_t square, Bitboard occupied) {
-    const MagicEntry& entry = MagicData::rookMagics[square];
-    Bitboard blockers = occupied & entry.mask;
-    uint64_t ind = magicIndex(entry, blockers);
-    return rookMoves[square][ind];
+#ifdef CHESS_PEXT_AVAILABLE
+    if (usePext) {
+        return rookMovesPext(square, occupied);
+    }
+#endif
+    return rookMovesMagic(square, occupied);
 }
 
 Bitboard PregeneratedMoves::getBishopMoves(uint8_t square, Bitboard occupied) {
-    const MagicEntry& entry = MagicData::bishopMagics[square];
-    Bitboard blockers = occupied & entry.mask;
-    uint64_t ind = magicIndex(entry, blockers);
-    return bishopMoves[square][ind];
+#ifdef CHESS_PEXT_AVAILABLE
+    if (usePext) {
+        return bishopMovesPext(square, occupied);
+    }
+#endif
+    return bishopMovesMagic(square, occupied);
 }
 
 Bitboard PregeneratedMoves::getQueenMoves(uint8_t square, Bitboard occupied) {
@@ -145,25 +264,19 @@ Bitboard PregeneratedMoves::getLine(uint8_t src, uint8_t dst) {
 }
 
 void PregeneratedMoves::init() {
-    for (uint8_t square = 0; square < 64; square++) {
-        knightMoves[square] = genKnightMoves(square);
-        kingMoves[square] = genKingMoves(square);
-
-        const MagicEntry& rookMagic = MagicData::rookMagics[square];
-        std::vector<Bitboard> rookSubsets = Utils::getSubsets(rookMagic.mask);
-        for (Bitboard board : rookSubsets) {
-            uint64_t index = magicIndex(rookMagic, board);
-            rookMoves[square][index] = getSlidingMoves(square, board, true);
-        }
-
-        const MagicEntry& bishopMagic = MagicData::bishopMagics[square];
-        std::vector<Bitboard> bishopSubsets = Utils::getSubsets(bishopMagic.mask);
-        for (Bitboard board : bishopSubsets) {
-            uint64_t index = magicIndex(bishopMagic, board);
-            bishopMoves[square][index] = getSlidingMoves(square, board, false);
-        }
+    init(Cpu::hasFastPext() ? SliderIndexing::Pext : SliderIndexing::Magic);
+}
 
-        setBetween(square);
-        setLine(square);
+void PregeneratedMoves::init(SliderIndexing indexing) {
+    sliderIndexing = SliderIndexing::Magic;
+#ifdef CHESS_PEXT_AVAILABLE
+    if (indexing == SliderIndexing::Pext && Cpu::hasBmi2()) {
+        sliderIndexing = SliderIndexing::Pext;
     }
-}
\ No newline at end of file
+#endif
+    usePext = sliderIndexing == SliderIndexing::Pext;
+}
+
+PregeneratedMoves::SliderIndexing PregeneratedMoves::getSliderIndexing() {
+    return sliderIndexing;
+}
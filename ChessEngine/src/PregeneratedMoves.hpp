@@ -1,12 +1,23 @@
 #pragma once
 
+#include <cstdint>
+
 #include "Bitboard.hpp"
 
 // Maybe should be singleton class instead of namespace because it stores state, idk 
 namespace Chess {
 	namespace PregeneratedMoves {
+		// How slider attack tables are indexed: a multiply and shift by the
+		// magics in MagicData, or BMI2 PEXT of the occupancy by the ray mask
+		enum class SliderIndexing : uint8_t { Magic, Pext };
 
+		// Every table is built at compile time, so lookups work without init
+		// using magics. init switches to PEXT when the CPU supports it at
+		// full speed.
 		void init();
+		// falls back to magic indexing when PEXT is unavailable
+		void init(SliderIndexing indexing);
+		SliderIndexing getSliderIndexing();
 
 		Bitboard getRookMoves(uint8_t square, Bitboard occupied);
 		Bitboard getBishopMoves(uint8_t square, Bitboard occupied);
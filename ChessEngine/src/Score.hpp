@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Chess {
+    // A middlegame and an endgame value packed into one integer, the endgame
+    // value in the upper 16 bits. Sums and differences of scores carry both
+    // halves along in a single instruction, as long as each half stays
+    // within 16 bits.
+    class Score {
+    public:
+        constexpr Score() : m_packed{} {}
+        constexpr Score(int middlegame, int endgame)
+            : m_packed{ static_cast<int32_t>(static_cast<uint32_t>(endgame) << 16) +
+                middlegame } {}
+
+        constexpr int middlegame() const {
+            return static_cast<int16_t>(static_cast<uint16_t>(m_packed));
+        }
+        // a negative middlegame half borrows one from the endgame half,
+        // rounding by 0x8000 gives it back
+        constexpr int endgame() const {
+            return static_cast<int16_t>(
+                static_cast<uint16_t>(static_cast<uint32_t>(m_packed + 0x8000) >> 16));
+        }
+
+        constexpr Score operator+(Score other) const { return fromPacked(m_packed + other.m_packed); }
+        constexpr Score operator-(Score other) const { return fromPacked(m_packed - other.m_packed); }
+        constexpr Score operator-() const { return fromPacked(-m_packed); }
+        constexpr Score operator*(int factor) const { return fromPacked(m_packed * factor); }
+        constexpr Score& operator+=(Score other) {
+            m_packed += other.m_packed;
+            return *this;
+        }
+        constexpr Score& operator-=(Score other) {
+            m_packed -= other.m_packed;
+            return *this;
+        }
+        constexpr bool operator==(const Score& other) const = default;
+
+    private:
+        int32_t m_packed;
+
+        static constexpr Score fromPacked(int32_t packed) {
+            Score score{};
+            score.m_packed = packed;
+            return score;
+        }
+    };
+
+    static_assert(Score{ -5, 7 }.middlegame() == -5 && Score{ -5, 7 }.endgame() == 7);
+    static_assert((Score{ 3, -9 } - Score{ 10, 4 }).endgame() == -13);
+    static_assert(Score{ -4, 6 } * 3 == Score{ -12, 18 });
+}
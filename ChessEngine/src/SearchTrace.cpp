@@ -0,0 +1,86 @@
+#include "SearchTrace.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace Chess;
+
+namespace {
+    constexpr size_t k_bufferSize = 1 << 16;
+
+    void putU16(char* out, uint16_t value) {
+        out[0] = static_cast<char>(value & 0xFF);
+        out[1] = static_cast<char>(value >> 8);
+    }
+
+    void putU32(char* out, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    uint16_t getU16(const char* in) {
+        return static_cast<uint16_t>(static_cast<uint8_t>(in[0]) |
+            (static_cast<uint8_t>(in[1]) << 8));
+    }
+
+    uint32_t getU32(const char* in) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+        }
+        return value;
+    }
+}  // namespace
+
+SearchTrace::SearchTrace(std::string_view path, uint64_t maxRecords)
+    : m_file{ std::string{ path }, std::ios::binary | std::ios::trunc },
+    m_buffer(k_bufferSize), m_maxRecords{ maxRecords } {
+    if (!m_file) {
+        throw std::runtime_error{ "Failed to open search trace file" };
+    }
+    char header[k_headerSize]{};
+    std::memcpy(header, k_magic, sizeof(k_magic));
+    putU32(header + 4, k_version);
+    putU32(header + 8, k_recordSize);
+    m_file.write(header, k_headerSize);
+}
+
+SearchTrace::~SearchTrace() { flush(); }
+
+void SearchTrace::flush() {
+    if (m_bufferPos == 0) return;
+    m_file.write(m_buffer.data(), m_bufferPos);
+    m_file.flush();
+    m_bufferPos = 0;
+}
+
+// layout: alpha, beta, score (int32), move (uint16, Move::raw), ply, depth,
+// type, reason, flags, one byte of padding
+void SearchTrace::encode(const Record& record, char* out) {
+    putU32(out, static_cast<uint32_t>(record.alpha));
+    putU32(out + 4, static_cast<uint32_t>(record.beta));
+    putU32(out + 8, static_cast<uint32_t>(record.score));
+    putU16(out + 12, record.move.raw());
+    out[14] = static_cast<char>(record.ply);
+    out[15] = static_cast<char>(record.depth);
+    out[16] = static_cast<char>(record.type);
+    out[17] = static_cast<char>(record.reason);
+    out[18] = static_cast<char>(record.flags);
+    out[19] = 0;
+}
+
+SearchTrace::Record SearchTrace::decode(const char* in) {
+    Record record{};
+    record.alpha = static_cast<int32_t>(getU32(in));
+    record.beta = static_cast<int32_t>(getU32(in + 4));
+    record.score = static_cast<int32_t>(getU32(in + 8));
+    record.move = Move::fromRaw(getU16(in + 12));
+    record.ply = static_cast<uint8_t>(in[14]);
+    record.depth = static_cast<int8_t>(in[15]);
+    record.type = static_cast<NodeType>(in[16]);
+    record.reason = static_cast<Reason>(in[17]);
+    record.flags = static_cast<uint8_t>(in[18]);
+    return record;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+#include "Move.hpp"
+
+namespace Chess {
+    // Streams one fixed size record per search node to a binary file so the
+    // shape of the tree can be inspected offline (see the TraceViewer tool).
+    // Records are written when a node returns, so children precede their parent.
+    class SearchTrace {
+    public:
+        static constexpr char k_magic[4] = { 'C', 'S', 'T', 'R' };
+        static constexpr uint32_t k_version = 2;
+        static constexpr size_t k_headerSize = 12;
+        static constexpr size_t k_recordSize = 20;
+
+        enum class NodeType : uint8_t { Root, PV, NonPV, Quiescence };
+
+        enum class Reason : uint8_t {
+            Exact,          // searched every move, score inside the window
+            FailLow,        // searched every move, nothing beat alpha
+            BetaCutoff,
+            StandPat,       // quiescence static eval was already >= beta
+            Transposition,  // cut by a transposition table hit
+            Repetition,
+            Checkmate,
+            Stalemate,
+            TimeUp
+        };
+
+        enum Flag : uint8_t {
+            Research = 0b1  // PVS re-search after a null window fail high
+        };
+
+        struct Record {
+            int32_t alpha{};
+            int32_t beta{};
+            int32_t score{};
+            Move move{};
+            uint8_t ply{};
+            int8_t depth{};
+            NodeType type{};
+            Reason reason{};
+            uint8_t flags{};
+        };
+
+        SearchTrace(std::string_view path, uint64_t maxRecords);
+        ~SearchTrace();
+
+        SearchTrace(const SearchTrace&) = delete;
+        SearchTrace& operator=(const SearchTrace&) = delete;
+
+        void write(const Record& record) {
+            if (m_written >= m_maxRecords) {
+                m_dropped++;
+                return;
+            }
+            if (m_buffer.size() - m_bufferPos < k_recordSize) {
+                flush();
+            }
+            encode(record, m_buffer.data() + m_bufferPos);
+            m_bufferPos += k_recordSize;
+            m_written++;
+        }
+
+        void flush();
+
+        uint64_t getWritten() const { return m_written; }
+        uint64_t getDropped() const { return m_dropped; }
+
+        static void encode(const Record& record, char* out);
+        static Record decode(const char* in);
+
+    private:
+        std::ofstream m_file;
+        std::vector<char> m_buffer;
+        size_t m_bufferPos{ 0 };
+        uint64_t m_maxRecords;
+        uint64_t m_written{ 0 };
+        uint64_t m_dropped{ 0 };
+    };
+}
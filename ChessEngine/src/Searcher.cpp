@@ -28,65 +28,162 @@ namespace {
 
 using namespace Chess;
 
-int Searcher::quiescenceSearch(Position& position, int alpha, int beta) {
-    int score = Evaluator::evaluate(position);
+Searcher::TraceFrame Searcher::beginTrace(int ply, int depth, int alpha, int beta,
+    SearchTrace::NodeType type) {
+    // the frame only ever goes back to endTrace, which ignores it too
+    if (!m_trace) {
+        return {};
+    }
+    const TraceFrame frame{ m_traceMove, alpha, beta, ply, depth, type, m_traceFlags };
+    m_traceFlags = 0;
+    return frame;
+}
+
+int Searcher::endTrace(const TraceFrame& frame, int score,
+    SearchTrace::Reason reason) {
+    if (m_trace) {
+        m_trace->write({ .alpha = frame.alpha,
+                         .beta = frame.beta,
+                         .score = score,
+                         .move = frame.move,
+                         .ply = static_cast<uint8_t>(frame.ply),
+                         .depth = static_cast<int8_t>(frame.depth),
+                         .type = frame.type,
+                         .reason = reason,
+                         .flags = frame.flags });
+    }
+    return score;
+}
+
+template <Searcher::MoveStrategy Strategy>
+Position& Searcher::makeMove(Position& position, Move move, Position::UndoState& undo,
+    int distance) {
+    if constexpr (Strategy == MoveStrategy::CopyMake) {
+        Position& child = m_plyPositions[distance];
+        child = position;
+        if (child.usesNnue()) {
+            child.copyAccumulatorTo(m_accumulators[distance]);
+        }
+        child.makeMove(move, undo);
+        return child;
+    }
+    else {
+        position.makeMove(move, undo);
+        return position;
+    }
+}
+
+template <Searcher::MoveStrategy Strategy>
+void Searcher::unmakeMove(Position& position, Move move, const Position::UndoState& undo) {
+    // a copied parent was never changed
+    if constexpr (Strategy == MoveStrategy::MakeUnmake) {
+        position.unmakeMove(move, undo);
+    }
+}
+
+template <Searcher::MoveStrategy Strategy>
+int Searcher::quiescenceSearch(Position& position, int ply, int alpha, int beta) {
+    using Reason = SearchTrace::Reason;
+    const TraceFrame frame =
+        beginTrace(ply, 0, alpha, beta, SearchTrace::NodeType::Quiescence);
+
+    m_nodes++;
+
+    // Only whether the stand pat score clears alpha or beta matters here.
+    // Lazy scores hold for this window alone, so only complete ones are cached.
+    m_evalCacheProbes++;
+    int score;
+    if (const std::optional<int> cached = m_evalCache->probe(position.getZobrist())) {
+        m_evalCacheHits++;
+        score = *cached;
+    }
+    else {
+        bool complete;
+        score = Evaluator::evaluate(position, m_pawnTable, alpha, beta, complete);
+        if (complete) {
+            m_evalCache->store(position.getZobrist(), score);
+        }
+    }
     if (score >= beta) {
-        return beta;
+        return endTrace(frame, beta, Reason::StandPat);
     }
     if (score > alpha) {
         alpha = score;
     }
 
-    SortedMoves legalMoves{ position, m_killerMoves, m_history, Move{},
-                           0,        true,          nullptr };
+    // already in MVV-LVA order, so there is nothing to score or sort
+    MoveList moves{};
+    MoveGenerator::generateCaptures(position, moves);
 
-    while (legalMoves.hasNext()) {
-        Move move = legalMoves.getNext();
-        position.makeMove(move);
-        int score = -quiescenceSearch(position, -beta, -alpha);
-        position.unmakeMove(move);
+    for (Move move : moves) {
+        Position::UndoState undo;
+        Position& child = makeMove<Strategy>(position, move, undo, ply + 1);
+        m_traceMove = move;
+        int score = -quiescenceSearch<Strategy>(child, ply + 1, -beta, -alpha);
+        unmakeMove<Strategy>(position, move, undo);
         if (score >= beta) {
-            return beta;
+            return endTrace(frame, beta, Reason::BetaCutoff);
         }
         if (score > alpha) {
             alpha = score;
         }
     }
-    return alpha;
+    return endTrace(frame, alpha,
+        alpha > frame.alpha ? Reason::Exact : Reason::FailLow);
 }
 
+template <Searcher::MoveStrategy Strategy>
 int Searcher::search(Position& position, int depth, int ply, int alpha,
     int beta, bool isPV) {
+    using Reason = SearchTrace::Reason;
+    // ply counts from the root's children, the trace counts from the root
+    const TraceFrame frame = beginTrace(ply + 1, depth, alpha, beta,
+        isPV ? SearchTrace::NodeType::PV : SearchTrace::NodeType::NonPV);
+
     if (m_timeUp) {
-        return 0;
+        return endTrace(frame, 0, Reason::TimeUp);
     }
 
-    m_nodes++;
+    // a horizon node is counted by the quiescence search it hands over to
+    if (depth > 0) {
+        m_nodes++;
+    }
 
-    if (position.hasRepeatedThreefold()) return 0;
+    // this node is ply + 1 away from the root
+    if (m_gameHistory.isRepetitionDraw(position, ply + 1)) {
+        return endTrace(frame, 0, Reason::Repetition);
+    }
+    // we can force a draw by repeating, so the node is worth at least that
+    if (alpha < 0 && m_gameHistory.hasUpcomingRepetition(position, ply + 1)) {
+        alpha = 0;
+        if (alpha >= beta) {
+            return endTrace(frame, alpha, Reason::Repetition);
+        }
+    }
 
     if (depth == 0) {
-        return quiescenceSearch(position, alpha, beta);
+        // the quiescence node records this position in our place
+        m_traceFlags = frame.flags;
+        return quiescenceSearch<Strategy>(position, ply + 1, alpha, beta);
     }
 
     if (auto hashedScore =
         m_transpositionTable.probeScore(position, depth, ply, alpha, beta)) {
         m_transpositions++;
-        return *hashedScore;
+        return endTrace(frame, *hashedScore, Reason::Transposition);
     }
 
     Move hashedMove = m_transpositionTable.probeMove(position);
 
-    bool inCheck;
-    SortedMoves legalMoves{ position, m_killerMoves, m_history, hashedMove,
-                           depth,    false,         &inCheck };
+    SortedMoves legalMoves{ position, m_killerMoves, m_history, hashedMove, depth };
 
     if (legalMoves.size() == 0) {
-        if (inCheck) {
-            return -(posInfinity - ply);
+        // generating the moves already computed the check info
+        if (position.inCheck()) {
+            return endTrace(frame, -(posInfinity - ply), Reason::Checkmate);
         }
         else {
-            return 0;
+            return endTrace(frame, 0, Reason::Stalemate);
         }
     }
 
@@ -95,22 +192,28 @@ int Searcher::search(Position& position, int depth, int ply, int alpha,
     while (legalMoves.hasNext()) {
         Move move = legalMoves.getNext();
 
-        position.makeMove(move);
+        Position::UndoState undo;
+        Position& child = makeMove<Strategy>(position, move, undo, ply + 2);
+        m_gameHistory.push(child);
+        m_traceMove = move;
         int score;
         if (isPV && flag == TranspositionEntry::Exact) {
-            score = -search(position, depth - 1, ply + 1, -alpha - 1, -alpha, false);
+            score = -search<Strategy>(child, depth - 1, ply + 1, -alpha - 1, -alpha, false);
             if (score > alpha) {
-                score = -search(position, depth - 1, ply + 1, -beta, -alpha, true);
+                m_traceMove = move;
+                m_traceFlags = SearchTrace::Research;
+                score = -search<Strategy>(child, depth - 1, ply + 1, -beta, -alpha, true);
             }
 
         }
         else {
-            score = -search(position, depth - 1, ply + 1, -beta, -alpha, isPV);
+            score = -search<Strategy>(child, depth - 1, ply + 1, -beta, -alpha, isPV);
         }
-        position.unmakeMove(move);
+        m_gameHistory.pop();
+        unmakeMove<Strategy>(position, move, undo);
 
         if (m_timeUp) {
-            return 0;
+            return endTrace(frame, 0, Reason::TimeUp);
         }
 
         if (score > alpha) {
@@ -121,51 +224,63 @@ int Searcher::search(Position& position, int depth, int ply, int alpha,
         if (score >= beta) {
             m_transpositionTable.tryStore(position, move, depth, beta,
                 TranspositionEntry::Lower);
-            if (!position.getPieceAt(move.target)) {
+            if (!move.isCapture()) {
                 m_killerMoves[depth][1] = m_killerMoves[depth][0];
                 m_killerMoves[depth][0] = move;
-                m_history[static_cast<uint8_t>(position.getTurn())][move.start]
-                    [move.target] += depth * depth;
-                if (m_history[static_cast<uint8_t>(position.getTurn())][move.start]
-                    [move.target] >= k_killerScore) {
-                    m_history[static_cast<uint8_t>(position.getTurn())][move.start]
-                        [move.target] /= 2;
+                int& history = m_history[static_cast<uint8_t>(position.getTurn())]
+                    [move.start()][move.target()];
+                history += depth * depth;
+                if (history >= k_killerScore) {
+                    history /= 2;
                 }
             }
 
-            return beta;
+            return endTrace(frame, beta, Reason::BetaCutoff);
         }
     }
     m_transpositionTable.tryStore(position, choice, depth, alpha, flag);
-    return alpha;
+    return endTrace(frame, alpha,
+        flag == TranspositionEntry::Exact ? Reason::Exact : Reason::FailLow);
 }
 
+template <Searcher::MoveStrategy Strategy>
 std::pair<Move, int> Searcher::rootSearch(Position& position, int depth) {
+    using Reason = SearchTrace::Reason;
     int alpha = negInfinity - maxDepth;
     int beta = posInfinity + maxDepth;
     Move choice;
 
+    m_traceMove = Move{};
+    const TraceFrame frame =
+        beginTrace(0, depth, alpha, beta, SearchTrace::NodeType::Root);
+
     Move hashedMove = m_transpositionTable.probeMove(position);
-    SortedMoves legalMoves{ position, m_killerMoves, m_history, hashedMove,
-                           depth,    false,         nullptr };
+    SortedMoves legalMoves{ position, m_killerMoves, m_history, hashedMove, depth };
 
     while (legalMoves.hasNext()) {
         Move move = legalMoves.getNext();
 
-        position.makeMove(move);
+        Position::UndoState undo;
+        Position& child = makeMove<Strategy>(position, move, undo, 1);
+        m_gameHistory.push(child);
+        m_traceMove = move;
         int score;
         if (alpha == negInfinity - maxDepth) {
-            score = -search(position, depth - 1, 0, -beta, -alpha, true);
+            score = -search<Strategy>(child, depth - 1, 0, -beta, -alpha, true);
         }
         else {
-            score = -search(position, depth - 1, 0, -alpha - 1, -alpha, false);
+            score = -search<Strategy>(child, depth - 1, 0, -alpha - 1, -alpha, false);
             if (score > alpha) {
-                score = -search(position, depth - 1, 0, -beta, -alpha, true);
+                m_traceMove = move;
+                m_traceFlags = SearchTrace::Research;
+                score = -search<Strategy>(child, depth - 1, 0, -beta, -alpha, true);
             }
         }
-        position.unmakeMove(move);
+        m_gameHistory.pop();
+        unmakeMove<Strategy>(position, move, undo);
 
         if (m_timeUp) {
+            endTrace(frame, 0, Reason::TimeUp);
             return {};
         }
 
@@ -180,35 +295,79 @@ std::pair<Move, int> Searcher::rootSearch(Position& position, int depth) {
     m_transpositionTable.tryStore(position, choice, depth, alpha,
         TranspositionEntry::Exact);
 
+    endTrace(frame, alpha, Reason::Exact);
     return { choice, alpha };
 }
 
-Move Searcher::getMove(const Position& position, int thinkMilliseconds) {
+void Searcher::startTrace(std::string_view path, uint64_t maxNodes) {
+    m_trace = std::make_unique<SearchTrace>(path, maxNodes);
+    m_traceFlags = 0;
+}
+
+void Searcher::stopTrace() { m_trace.reset(); }
+
+Move Searcher::iterativeDeepening(const Position& position, const GameHistory& history,
+    int maxDepth) {
+    // scores from another evaluation would mix with the new one's
+    if (m_nnueGeneration != Nnue::getGeneration()) {
+        clear();
+        m_nnueGeneration = Nnue::getGeneration();
+    }
+
     Move choice;
-    int eval;
-    std::thread timeUpThread{ [this, thinkMilliseconds]() {
-      std::this_thread::sleep_for(std::chrono::milliseconds(thinkMilliseconds));
-      this->m_timeUp = true;
-    } };
-    int depth = 1;
+    m_nodes = 0;
+    m_transpositions = 0;
+    m_evalCacheProbes = 0;
+    m_evalCacheHits = 0;
 
+    // the search pushes one key per ply and never grows the copy past this
+    m_gameHistory = history;
+    m_gameHistory.reserve(history.size() + maxDepth);
     Position clone{ position };
-    for (; depth < 64; depth++) {
-        auto [move, score] = rootSearch(clone, depth);
+    // the root's accumulator, when a network is loaded
+    clone.attachAccumulator(&m_accumulators[0]);
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        auto [move, score] = m_moveStrategy == MoveStrategy::CopyMake
+            ? rootSearch<MoveStrategy::CopyMake>(clone, depth)
+            : rootSearch<MoveStrategy::MakeUnmake>(clone, depth);
         if (m_timeUp || move == Move{}) {
             break;
         }
         choice = move;
-        eval = score;
     }
 
-    std::memset(m_killerMoves.data(), 0, sizeof(m_killerMoves));
-    std::memset(m_history.data(), 0, sizeof(m_history));
+    m_killerMoves = {};
+    m_history = {};
 
-    m_nodes = 0;
-    m_transpositions = 0;
+    if (m_trace) {
+        m_trace->flush();
+    }
+    return choice;
+}
+
+Move Searcher::getMove(const Position& position, const GameHistory& history,
+    int thinkMilliseconds) {
+    std::thread timeUpThread{ [this, thinkMilliseconds]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(thinkMilliseconds));
+      this->m_timeUp = true;
+    } };
+
+    const Move choice = iterativeDeepening(position, history, maxDepth - 1);
 
     timeUpThread.join();
     m_timeUp = false;
     return choice;
-}
\ No newline at end of file
+}
+
+Move Searcher::getMoveAtDepth(const Position& position, const GameHistory& history,
+    int depth) {
+    return iterativeDeepening(position, history, std::min(depth, maxDepth - 1));
+}
+
+void Searcher::clear() {
+    m_transpositionTable.clear();
+    m_pawnTable.clear();
+    m_evalCache->clear();
+    m_killerMoves = {};
+    m_history = {};
+}
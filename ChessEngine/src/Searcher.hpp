@@ -1,32 +1,121 @@
 #pragma once
 
+#include <memory>
+#include <string_view>
 #include <utility>
 
+#include "EvalCache.hpp"
+#include "GameHistory.hpp"
 #include "Move.hpp"
+#include "Nnue.hpp"
+#include "PawnTable.hpp"
+#include "Position.hpp"
+#include "SearchTrace.hpp"
 #include "Transposition.hpp"
 #include "DataStructures.hpp"
 
 namespace Chess {
-    class Position;
-
     class Searcher {
     public:
+        // How the search reaches a child position. MakeUnmake plays the move
+        // on the parent and takes it back afterwards, CopyMake plays it on a
+        // copy of the parent kept for that ply and never takes anything back.
+        enum class MoveStrategy { MakeUnmake, CopyMake };
+
         Searcher() = default;
-        Move getMove(const Position& position, int thinkMilliseconds = 1000);
+        // history holds the game up to and including position, for repetitions
+        Move getMove(const Position& position, const GameHistory& history,
+            int thinkMilliseconds = 1000);
+        // iterative deepening up to depth with no time limit, deterministic for
+        // a given position and table state
+        Move getMoveAtDepth(const Position& position, const GameHistory& history,
+            int depth);
+
+        // forget the transposition, pawn and evaluation tables, killers and
+        // history. Searches do this themselves after a network is loaded.
+        void clear();
+
+        // Replaces the searcher's own evaluation cache. Searchers given the
+        // same cache share it across threads, and clearing one clears it for all.
+        void setEvalCache(std::shared_ptr<EvalCache> cache) { m_evalCache = std::move(cache); }
+
+        void setMoveStrategy(MoveStrategy strategy) { m_moveStrategy = strategy; }
+        MoveStrategy getMoveStrategy() const { return m_moveStrategy; }
+
+        // nodes (including quiescence nodes) visited by the last search
+        uint64_t getNodes() const { return m_nodes; }
+        // stand pat evaluations of the last search looked up in the evaluation
+        // cache, and how many of them were found there
+        uint64_t getEvalCacheProbes() const { return m_evalCacheProbes; }
+        uint64_t getEvalCacheHits() const { return m_evalCacheHits; }
+
+        // Every node of subsequent searches is written to path until maxNodes
+        // records have been written or stopTrace is called
+        void startTrace(std::string_view path, uint64_t maxNodes = 10'000'000);
+        void stopTrace();
 
     private:
+        struct TraceFrame {
+            Move move;
+            int alpha;
+            int beta;
+            int ply;
+            int depth;
+            SearchTrace::NodeType type;
+            uint8_t flags;
+        };
+
         TranspositionTable m_transpositionTable{};
+        PawnTable m_pawnTable{};
+        std::shared_ptr<EvalCache> m_evalCache{ std::make_shared<EvalCache>() };
         Array2D<Move, 64, 2> m_killerMoves{};
         Array3D<int, 2, 64, 64> m_history{};
 
         bool m_timeUp{ false };
-        int m_nodes{ 0 };
+        uint64_t m_nodes{ 0 };
         int m_transpositions{ 0 };
+        uint64_t m_evalCacheProbes{ 0 };
+        uint64_t m_evalCacheHits{ 0 };
+        // Nnue::getGeneration when the tables were last filled, they are
+        // cleared when a network has been loaded since
+        uint32_t m_nnueGeneration{ 0 };
+
+        // the game followed by the moves on the path to the current node
+        GameHistory m_gameHistory{};
+
+        MoveStrategy m_moveStrategy{ MoveStrategy::MakeUnmake };
+        // CopyMake's positions by distance from the root, quiescence included
+        HeapArray<Position, 256> m_plyPositions{};
+        // Network accumulators by distance from the root while a network is
+        // loaded. MakeUnmake updates the root's in place, CopyMake gives each
+        // ply's position its own copy.
+        HeapArray<Nnue::Accumulator, 256> m_accumulators{};
 
+        std::unique_ptr<SearchTrace> m_trace{};
+        // set by the parent before recursing so the child can record how it was reached
+        Move m_traceMove{};
+        uint8_t m_traceFlags{ 0 };
+
+        Move iterativeDeepening(const Position& position, const GameHistory& history,
+            int maxDepth);
+        template <MoveStrategy Strategy>
         std::pair<Move, int> rootSearch(Position& position, int depth);
+        template <MoveStrategy Strategy>
         int search(Position& position, int depth, int ply, int alpha, int beta,
             bool isPV);
-        int quiescenceSearch(Position& position, int alpha, int beta);
+        template <MoveStrategy Strategy>
+        int quiescenceSearch(Position& position, int ply, int alpha, int beta);
+
+        // returns the position to search the child at distance from the root in
+        template <MoveStrategy Strategy>
+        Position& makeMove(Position& position, Move move, Position::UndoState& undo,
+            int distance);
+        template <MoveStrategy Strategy>
+        void unmakeMove(Position& position, Move move, const Position::UndoState& undo);
+
+        TraceFrame beginTrace(int ply, int depth, int alpha, int beta,
+            SearchTrace::NodeType type);
+        int endTrace(const TraceFrame& frame, int score, SearchTrace::Reason reason);
     };
 
 }
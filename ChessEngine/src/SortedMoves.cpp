@@ -13,32 +13,29 @@ static int scoreMove(const Position& position, const Array2D<Move, 64, 2>& kille
     if (move == hashedMove) {
         return INT32_MAX;
     }
-    Piece toMove = position.getPieceAt(move.start);
-    Piece captured = position.getPieceAt(move.target);
-    if (move.promotion != PieceType::Null) {
-        return k_killerScore + 1000 + Evaluator::evaluatePiece(move.promotion) - 100;
+    if (move.isPromotion()) {
+        return k_killerScore + 1000 + Evaluator::evaluatePiece(move.promotion()) - 100;
     }
-    else if (captured.type != PieceType::Null) {
-        return k_killerScore + 1000 + Evaluator::evaluatePiece(captured.type) -
-            Evaluator::evaluatePiece(toMove.type);
+    else if (move.isCapture()) {
+        // en passant leaves the target square empty
+        const PieceType captured = move.flag() == MoveFlag::EnPassant ? PieceType::Pawn :
+            position.getPieceAt(move.target()).type;
+        return k_killerScore + 1000 + Evaluator::evaluatePiece(captured) -
+            Evaluator::evaluatePiece(position.getPieceAt(move.start()).type);
     }
     else if (killerMoves[depth][0] == move || killerMoves[depth][1] == move) {
         return k_killerScore;
     }
     else {
-        return history[static_cast<uint8_t>(position.getTurn())][move.start]
-            [move.target];
+        return history[static_cast<uint8_t>(position.getTurn())][move.start()]
+            [move.target()];
     }
 }
 
 SortedMoves::SortedMoves(const Position& position, const Array2D<Move, 64, 2>& killerMoves,
     const Array3D<int, 2, 64, 64>& history, Move hashedMove, int depth,
-    bool onlyCaptures, bool* checkStatus) {
-    bool inCheck =
-        MoveGenerator::generateLegal(position, m_moveList, onlyCaptures);
-    if (checkStatus != nullptr) {
-        *checkStatus = inCheck;
-    }
+    bool onlyCaptures) {
+    MoveGenerator::generateLegal(position, m_moveList, onlyCaptures);
     for (int i = 0; i < m_moveList.size(); i++) {
         m_scores[i] = scoreMove(position, killerMoves, history, hashedMove, depth,
             m_moveList[i]);
@@ -11,7 +11,7 @@ namespace Chess {
     public:
         SortedMoves(const Position& position, const Array2D<Move, 64, 2>& killerMoves,
             const Array3D<int, 2, 64, 64>& history, Move hashedMove, int depth,
-            bool onlyCaptures = false, bool* checkStatus = nullptr);
+            bool onlyCaptures = false);
         Move getNext();
         bool hasNext() const;
         uint8_t size() const;
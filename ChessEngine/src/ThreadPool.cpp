@@ -0,0 +1,94 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+using namespace Chess;
+
+ThreadPool::ThreadPool(int threads) {
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threads; i++) {
+        m_threads.emplace_back([this, i]() { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{ m_mutex };
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+int ThreadPool::defaultThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    m_pending++;
+    {
+        // counted before it is visible, so a worker that takes it right away
+        // cannot push the count below zero. Taking the lock orders this with
+        // a worker deciding to sleep
+        std::lock_guard lock{ m_mutex };
+        m_queued++;
+    }
+    Worker& worker = *m_workers[m_nextWorker++ % m_workers.size()];
+    {
+        std::lock_guard lock{ worker.mutex };
+        worker.tasks.push_back(std::move(task));
+    }
+    m_workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock{ m_mutex };
+    m_allDone.wait(lock, [this]() { return m_pending == 0; });
+}
+
+bool ThreadPool::tryTake(size_t index, std::function<void()>& task) {
+    {
+        Worker& own = *m_workers[index];
+        std::lock_guard lock{ own.mutex };
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < m_workers.size(); i++) {
+        Worker& victim = *m_workers[(index + i) % m_workers.size()];
+        std::lock_guard lock{ victim.mutex };
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t index) {
+    while (true) {
+        std::function<void()> task;
+        if (tryTake(index, task)) {
+            // the task was counted before it was pushed, so this stays >= 0
+            m_queued--;
+            task();
+            if (--m_pending == 0) {
+                std::lock_guard lock{ m_mutex };
+                m_allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock{ m_mutex };
+        m_workAvailable.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+        if (m_stopping && m_queued == 0) return;
+    }
+}
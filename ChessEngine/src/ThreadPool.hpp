@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Chess {
+    // Fixed size pool where every worker owns a deque. Workers run their own
+    // tasks newest first and steal the oldest task of another worker when idle,
+    // so uneven subtrees balance out without a single contended queue.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int threads = defaultThreads());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> task);
+        // blocks until every submitted task has finished
+        void wait();
+
+        int size() const { return static_cast<int>(m_threads.size()); }
+
+        static int defaultThreads();
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_allDone;
+        std::atomic<size_t> m_pending{ 0 };
+        std::atomic<size_t> m_queued{ 0 };
+        size_t m_nextWorker{ 0 };
+        bool m_stopping{ false };
+
+        void run(size_t index);
+        bool tryTake(size_t index, std::function<void()>& task);
+    };
+}
@@ -1,5 +1,7 @@
 #include "Transposition.hpp"
 
+#include <algorithm>
+
 #include "Position.hpp"
 
 using namespace Chess;
@@ -54,4 +56,8 @@ Move TranspositionTable::probeMove(const Position& position) {
         return entry->move;
     }
     return Move{};
-}
\ No newline at end of file
+}
+
+void TranspositionTable::clear() {
+    std::fill(m_table.begin(), m_table.end(), TranspositionEntry{});
+}
@@ -34,6 +34,8 @@ namespace Chess {
 
         Move probeMove(const Position& position);
 
+        void clear();
+
     private:
         HeapArray<TranspositionEntry, 1u << 20> m_table{};
     };
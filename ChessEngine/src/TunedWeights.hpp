@@ -0,0 +1,133 @@
+#pragma once
+
+// Generated by the Tuner tool, rerun it rather than editing by hand
+
+#include "EvalWeights.hpp"
+#include "Score.hpp"
+
+namespace Chess {
+    namespace EvalWeights {
+        inline constexpr Weights weights = {
+            // material
+            {
+                Score{ 100, 100 }, Score{ 310, 310 }, Score{ 300, 300 }, Score{ 500, 500 },
+                Score{ 800, 800 }, Score{ 0, 0 } },
+            // pieceSquares
+            {
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 50, 80 }, Score{ 50, 80 }, Score{ 50, 80 }, Score{ 50, 80 },
+                Score{ 50, 80 }, Score{ 50, 80 }, Score{ 50, 80 }, Score{ 50, 80 },
+                Score{ 10, 50 }, Score{ 10, 50 }, Score{ 20, 50 }, Score{ 30, 50 },
+                Score{ 30, 50 }, Score{ 20, 50 }, Score{ 10, 50 }, Score{ 10, 50 },
+                Score{ 5, 30 }, Score{ 5, 30 }, Score{ 10, 30 }, Score{ 25, 30 },
+                Score{ 25, 30 }, Score{ 10, 30 }, Score{ 5, 30 }, Score{ 5, 30 },
+                Score{ 0, 15 }, Score{ 0, 15 }, Score{ 0, 15 }, Score{ 20, 15 },
+                Score{ 20, 15 }, Score{ 0, 15 }, Score{ 0, 15 }, Score{ 0, 15 },
+                Score{ 5, 5 }, Score{ -5, 5 }, Score{ -10, 5 }, Score{ 0, 5 },
+                Score{ 0, 5 }, Score{ -10, 5 }, Score{ -5, 5 }, Score{ 5, 5 },
+                Score{ 5, 0 }, Score{ 10, 0 }, Score{ 10, 0 }, Score{ -20, 0 },
+                Score{ -20, 0 }, Score{ 10, 0 }, Score{ 10, 0 }, Score{ 5, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ -20, -20 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -20, -20 },
+                Score{ -10, -10 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 0, 0 }, Score{ 5, 5 }, Score{ 10, 10 },
+                Score{ 10, 10 }, Score{ 5, 5 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 5, 5 }, Score{ 5, 5 }, Score{ 10, 10 },
+                Score{ 10, 10 }, Score{ 5, 5 }, Score{ 5, 5 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 0, 0 }, Score{ 10, 10 }, Score{ 10, 10 },
+                Score{ 10, 10 }, Score{ 10, 10 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 10, 10 }, Score{ 10, 10 }, Score{ 10, 10 },
+                Score{ 10, 10 }, Score{ 10, 10 }, Score{ 10, 10 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 5, 5 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 5, 5 }, Score{ -10, -10 },
+                Score{ -20, -20 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -20, -20 },
+                Score{ -50, -50 }, Score{ -40, -40 }, Score{ -30, -30 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ -30, -30 }, Score{ -40, -40 }, Score{ -50, -50 },
+                Score{ -40, -40 }, Score{ -20, -20 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ -20, -20 }, Score{ -40, -40 },
+                Score{ -30, -30 }, Score{ 0, 0 }, Score{ 10, 10 }, Score{ 15, 15 },
+                Score{ 15, 15 }, Score{ 10, 10 }, Score{ 0, 0 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ 5, 5 }, Score{ 15, 15 }, Score{ 20, 20 },
+                Score{ 20, 20 }, Score{ 15, 15 }, Score{ 5, 5 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ 0, 0 }, Score{ 15, 15 }, Score{ 20, 20 },
+                Score{ 20, 20 }, Score{ 15, 15 }, Score{ 0, 0 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ 5, 5 }, Score{ 10, 10 }, Score{ 15, 15 },
+                Score{ 15, 15 }, Score{ 10, 10 }, Score{ 5, 5 }, Score{ -30, -30 },
+                Score{ -40, -40 }, Score{ -20, -20 }, Score{ 0, 0 }, Score{ 5, 5 },
+                Score{ 5, 5 }, Score{ 0, 0 }, Score{ -20, -20 }, Score{ -40, -40 },
+                Score{ -50, -50 }, Score{ -40, -40 }, Score{ -30, -30 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ -30, -30 }, Score{ -40, -40 }, Score{ -50, -50 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 5, 5 }, Score{ 10, 10 }, Score{ 10, 10 }, Score{ 10, 10 },
+                Score{ 10, 10 }, Score{ 10, 10 }, Score{ 10, 10 }, Score{ 5, 5 },
+                Score{ -5, -5 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ -5, -5 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ -5, -5 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ -5, -5 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ -5, -5 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 5, 5 },
+                Score{ 5, 5 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ -20, -20 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -5, -5 },
+                Score{ -5, -5 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -20, -20 },
+                Score{ -10, -10 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 0, 0 }, Score{ 5, 5 }, Score{ 5, 5 },
+                Score{ 5, 5 }, Score{ 5, 5 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -5, -5 }, Score{ 0, 0 }, Score{ 5, 5 }, Score{ 5, 5 },
+                Score{ 5, 5 }, Score{ 5, 5 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 5, 5 }, Score{ 5, 5 },
+                Score{ 5, 5 }, Score{ 5, 5 }, Score{ 0, 0 }, Score{ -5, -5 },
+                Score{ -10, -10 }, Score{ 5, 5 }, Score{ 5, 5 }, Score{ 5, 5 },
+                Score{ 5, 5 }, Score{ 5, 5 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -10, -10 }, Score{ 0, 0 }, Score{ 5, 5 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 0, 0 }, Score{ -10, -10 },
+                Score{ -20, -20 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -5, -5 },
+                Score{ -5, -5 }, Score{ -10, -10 }, Score{ -10, -10 }, Score{ -20, -20 },
+                Score{ -30, -50 }, Score{ -40, -40 }, Score{ -40, -30 }, Score{ -50, -20 },
+                Score{ -50, -20 }, Score{ -40, -30 }, Score{ -40, -40 }, Score{ -30, -50 },
+                Score{ -30, -30 }, Score{ -40, -20 }, Score{ -40, -10 }, Score{ -50, 0 },
+                Score{ -50, 0 }, Score{ -40, -10 }, Score{ -40, -20 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ -40, -10 }, Score{ -40, 20 }, Score{ -50, 30 },
+                Score{ -50, 30 }, Score{ -40, 20 }, Score{ -40, -10 }, Score{ -30, -30 },
+                Score{ -30, -30 }, Score{ -40, -10 }, Score{ -40, 30 }, Score{ -50, 40 },
+                Score{ -50, 40 }, Score{ -40, 30 }, Score{ -40, -10 }, Score{ -30, -30 },
+                Score{ -20, -30 }, Score{ -30, -10 }, Score{ -30, 30 }, Score{ -40, 40 },
+                Score{ -40, 40 }, Score{ -30, 30 }, Score{ -30, -10 }, Score{ -20, -30 },
+                Score{ -10, -30 }, Score{ -20, -10 }, Score{ -20, 20 }, Score{ -20, 30 },
+                Score{ -20, 30 }, Score{ -20, 20 }, Score{ -20, -10 }, Score{ -10, -30 },
+                Score{ 20, -30 }, Score{ 20, -30 }, Score{ 0, 0 }, Score{ 0, 0 },
+                Score{ 0, 0 }, Score{ 0, 0 }, Score{ 20, -30 }, Score{ 20, -30 },
+                Score{ 20, -50 }, Score{ 30, -30 }, Score{ 10, -30 }, Score{ 0, -30 },
+                Score{ 0, -30 }, Score{ 10, -30 }, Score{ 30, -30 }, Score{ 20, -50 } },
+            // doubledPawn
+            Score{ -10, -25 },
+            // isolatedPawn
+            Score{ -12, -15 },
+            // backwardPawn
+            Score{ -8, -10 },
+            // passedPawn
+            {
+                Score{ 0, 0 }, Score{ 0, 5 }, Score{ 5, 10 }, Score{ 10, 20 },
+                Score{ 20, 35 }, Score{ 35, 55 }, Score{ 60, 80 }, Score{ 0, 0 } },
+            // mobility
+            {
+                Score{ 0, 0 }, Score{ 5, 5 }, Score{ 4, 4 }, Score{ 2, 4 },
+                Score{ 1, 2 }, Score{ 0, 0 } },
+            // threatByPawn
+            Score{ 40, 30 },
+            // threatByMinor
+            Score{ 25, 20 },
+        };
+    }  // namespace EvalWeights
+}
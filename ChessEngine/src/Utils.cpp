@@ -3,9 +3,11 @@
 #include <cstdint>
 #include <sstream>
 #include <iostream>
-#include <cassert>
+#include <stdexcept>
 #include <string_view>
 
+#include "MoveGenerator.hpp"
+
 using namespace Chess;
 
 std::string Utils::squareToStr(uint8_t square) {
@@ -19,7 +21,11 @@ std::string Utils::squareToStr(uint8_t square) {
 }
 
 std::string Utils::moveToStr(Move move) {
-    return squareToStr(move.start) + squareToStr(move.target);
+    std::string str = squareToStr(move.start()) + squareToStr(move.target());
+    if (move.isPromotion()) {
+        str += static_cast<char>(tolower(pieceToChar(Piece{ move.promotion() })));
+    }
+    return str;
 }
 
 char Utils::pieceToChar(Piece piece) {
@@ -68,8 +74,10 @@ PieceType Utils::charToPieceType(char c) {
     }
 }
 
-Move Utils::strToMove(std::string_view moveStr) {
-    assert(moveStr.length() >= 4);
+Move Utils::strToMove(std::string_view moveStr, const Position& position) {
+    if (moveStr.length() < 4) {
+        throw std::invalid_argument{ "Invalid move string" };
+    }
     int rowStart = 7 - (moveStr[1] - '1');
     int rowEnd = 7 - (moveStr[3] - '1');
     int colStart = moveStr[0] - 'a';
@@ -79,8 +87,17 @@ Move Utils::strToMove(std::string_view moveStr) {
     uint8_t squareEnd = static_cast<uint8_t>(rowEnd * 8 + colEnd);
 
     PieceType promotion = moveStr.length() > 4 ? charToPieceType(moveStr[4]) : PieceType::Null;
-    
-    return Move{ squareStart, squareEnd, promotion};
+
+    // the string does not say what kind of move it is, the legal move does
+    MoveList legalMoves{};
+    MoveGenerator::generateLegal(position, legalMoves);
+    for (Move move : legalMoves) {
+        if (move.start() == squareStart && move.target() == squareEnd &&
+            move.promotion() == promotion) {
+            return move;
+        }
+    }
+    throw std::invalid_argument{ "Illegal move" };
 }
 
 std::vector<Bitboard> Utils::getSubsets(Bitboard board) {
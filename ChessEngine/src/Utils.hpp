@@ -16,24 +16,24 @@ namespace Chess {
             int row;
             int col;
 
-            static Coordinate fromSquare(uint8_t square) {
+            static constexpr Coordinate fromSquare(uint8_t square) {
                 return Coordinate{ square / 8, square % 8 };
             }
 
-            uint8_t toSquare() const { return row * 8 + col; }
+            constexpr uint8_t toSquare() const { return row * 8 + col; }
 
-            bool inBounds() const { return row >= 0 && row < 8 && col >= 0 && col < 8; }
-            Coordinate operator+(Coordinate other) const {
+            constexpr bool inBounds() const { return row >= 0 && row < 8 && col >= 0 && col < 8; }
+            constexpr Coordinate operator+(Coordinate other) const {
                 return Coordinate{ row + other.row, col + other.col };
             }
-            Coordinate operator-(Coordinate other) const {
+            constexpr Coordinate operator-(Coordinate other) const {
                 return Coordinate{ row - other.row, col - other.col };
             }
-            void operator+=(Coordinate other) {
+            constexpr void operator+=(Coordinate other) {
                 row += other.row;
                 col += other.col;
             }
-            void operator-=(Coordinate other) {
+            constexpr void operator-=(Coordinate other) {
                 row -= other.row;
                 col -= other.col;
             }
@@ -50,7 +50,8 @@ namespace Chess {
 
         std::string moveToStr(Move move);
 
-        Move strToMove(std::string_view strMove);
+        // the legal move in position written as strMove, throws if there is none
+        Move strToMove(std::string_view strMove, const Position& position);
 
         char pieceToChar(Piece piece);
 
@@ -1,18 +1,33 @@
 #include "Zobrist.hpp"
 
 #include <cstdint>
-#include <random>
+#include <utility>
 
+#include "DataStructures.hpp"
 #include "Piece.hpp"
 #include "Position.hpp"
 
 using namespace Chess;
 
 namespace {
-    bool initialized = false;
-
     constexpr size_t k_hashArrLength = 12 * 64 + 1 + 16 + 8;
-    uint64_t hashes[k_hashArrLength];
+
+    // splitmix64 with a fixed seed, evaluated at compile time so the keys are
+    // identical in every build and process
+    constexpr Array<uint64_t, k_hashArrLength> genHashes() {
+        Array<uint64_t, k_hashArrLength> hashes{};
+        uint64_t state = 1;
+        for (uint64_t& hash : hashes) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            hash = z ^ (z >> 31);
+        }
+        return hashes;
+    }
+
+    constexpr Array<uint64_t, k_hashArrLength> hashes = genHashes();
 
     constexpr size_t k_pieceOffset = 0;
     constexpr size_t k_blackToMoveOffset = k_pieceOffset + 64 * 12;
@@ -29,11 +44,77 @@ namespace {
 
     uint64_t hashBlackToMove() { return hashes[k_blackToMoveOffset]; }
 
-    uint64_t hashPiece(PieceType type, PieceColor color, uint8_t square) {
+    constexpr uint64_t hashPiece(PieceType type, PieceColor color, uint8_t square) {
         return hashes[k_pieceOffset + square * 12 + static_cast<uint8_t>(color) * 6 +
             static_cast<uint8_t>(type)];
     }
 
+    // whether type can move between the squares on an empty board
+    constexpr bool reaches(PieceType type, uint8_t from, uint8_t to) {
+        const int rows = from / 8 > to / 8 ? from / 8 - to / 8 : to / 8 - from / 8;
+        const int cols = from % 8 > to % 8 ? from % 8 - to % 8 : to % 8 - from % 8;
+        const bool diagonal = rows == cols;
+        const bool orthogonal = rows == 0 || cols == 0;
+        switch (type) {
+        case PieceType::Knight:
+            return rows * cols == 2;
+        case PieceType::Bishop:
+            return diagonal;
+        case PieceType::Rook:
+            return orthogonal;
+        case PieceType::Queen:
+            return diagonal || orthogonal;
+        case PieceType::King:
+            return rows <= 1 && cols <= 1;
+        default:
+            return false;
+        }
+    }
+
+    constexpr size_t cuckooIndex1(uint64_t key) { return key & 0x1FFF; }
+    constexpr size_t cuckooIndex2(uint64_t key) { return (key >> 16) & 0x1FFF; }
+
+    struct CuckooTable {
+        Array<uint64_t, 8192> keys{};
+        Array<Move, 8192> moves{};
+        size_t size = 0;
+    };
+
+    // Marcel van Kervinck's cuckoo hash of every reversible piece move, keyed
+    // by the change it makes to the Zobrist key. Each move has two possible
+    // slots, and inserting into an occupied one kicks the resident out to its
+    // other slot.
+    constexpr CuckooTable genCuckooTable() {
+        CuckooTable table{};
+        for (const PieceType type : { PieceType::Knight, PieceType::Bishop,
+            PieceType::Rook, PieceType::Queen, PieceType::King }) {
+            for (const PieceColor color : { PieceColor::White, PieceColor::Black }) {
+                for (uint8_t from = 0; from < 64; from++) {
+                    for (uint8_t to = from + 1; to < 64; to++) {
+                        if (!reaches(type, from, to)) continue;
+
+                        uint64_t key = hashPiece(type, color, from) ^
+                            hashPiece(type, color, to) ^ hashes[k_blackToMoveOffset];
+                        Move move{ from, to };
+                        size_t index = cuckooIndex1(key);
+                        while (true) {
+                            std::swap(table.keys[index], key);
+                            std::swap(table.moves[index], move);
+                            if (move == Move{}) break;
+                            index = index == cuckooIndex1(key) ? cuckooIndex2(key) :
+                                cuckooIndex1(key);
+                        }
+                        table.size++;
+                    }
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr CuckooTable cuckoo = genCuckooTable();
+    static_assert(cuckoo.size == 3668, "every reversible move must be in the table");
+
 }  // namespace
 
 Zobrist Zobrist::fromPosition(const Position& position) {
@@ -60,6 +141,28 @@ Zobrist Zobrist::fromPosition(const Position& position) {
     return Zobrist{ hash };
 }
 
+Zobrist Zobrist::pawnsFromPosition(const Position& position) {
+    uint64_t hash = 0;
+    for (uint8_t j = 0; j < 2; j++) {
+        Bitboard bb = position.getBitboard(PieceType::Pawn, static_cast<PieceColor>(j));
+        while (bb) {
+            hash ^= hashPiece(PieceType::Pawn, static_cast<PieceColor>(j), bb.popLSB());
+        }
+    }
+    return Zobrist{ hash };
+}
+
+Move Zobrist::findReversibleMove(Zobrist difference) {
+    const uint64_t key = difference.get();
+    if (cuckoo.keys[cuckooIndex1(key)] == key) {
+        return cuckoo.moves[cuckooIndex1(key)];
+    }
+    if (cuckoo.keys[cuckooIndex2(key)] == key) {
+        return cuckoo.moves[cuckooIndex2(key)];
+    }
+    return Move{};
+}
+
 void Zobrist::togglePiece(PieceType type, PieceColor color, uint8_t square) {
     m_hash ^= hashPiece(type, color, square);
 }
@@ -73,15 +176,3 @@ void Zobrist::toggleCastlingFlags(uint8_t flags) {
 void Zobrist::toggleEnPassantFile(uint8_t file) {
     m_hash ^= hashEnPassantFile(file);
 }
-
-void Zobrist::init() {
-    if (initialized) {
-        return;
-    }
-    std::mt19937 mt{ 1 };
-    std::uniform_int_distribution<uint64_t> gen(0, UINT64_MAX);
-    for (int i = 0; i < k_hashArrLength; i++) {
-        hashes[i] = gen(mt);
-    }
-    initialized = true;
-}
\ No newline at end of file
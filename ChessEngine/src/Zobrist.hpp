@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <functional>
 
+#include "Move.hpp"
 #include "Piece.hpp"
 
 namespace Chess {
@@ -10,9 +11,14 @@ namespace Chess {
 
 	class Zobrist {
 	public:
-		static void init();
-
 		static Zobrist fromPosition(const Position& position);
+		// key of the pawns alone, for tables keyed on pawn structure
+		static Zobrist pawnsFromPosition(const Position& position);
+
+		// The piece move between two squares that changes a key by difference,
+		// side to move included, or Move{} if there is none. Pawn moves, captures
+		// and castling are never found, only moves that could be played back.
+		static Move findReversibleMove(Zobrist difference);
 
 		Zobrist() = default;
 		explicit Zobrist(uint64_t hash) : m_hash{ hash } {}
@@ -10,6 +10,7 @@ static constexpr float k_thinkMultiplier = 0.005;
 
 GameHandler::GameHandler(const GameStartEvent& gameStart) :
 	m_position{ Chess::Position::fromFen(gameStart.startFen) },
+	m_history{ m_position },
 	m_color{ gameStart.color },
 	m_id{ gameStart.id },
 	m_timePerSide{ gameStart.timePerSide }  {
@@ -56,7 +57,7 @@ void GameHandler::run() {
 		if (split.size() > numMoves) {
 			for (int i = numMoves; i < split.size(); i++) {
 				LOG("Received move ", split[i]);
-				m_position.makeMove(Chess::Utils::strToMove(split[i]));
+				m_history.makeMove(m_position, Chess::Utils::strToMove(split[i], m_position));
 			}
 			numMoves = static_cast<int>(split.size());
 		}
@@ -74,7 +75,7 @@ void GameHandler::run() {
 bool GameHandler::sendMove() {
 	// Why are you like this Windows
 	const int thinkTimeMS = (std::min)(5000, static_cast<int>(k_thinkMultiplier * m_timePerSide));
-	const Chess::Move move = m_searcher.getMove(m_position, thinkTimeMS);
+	const Chess::Move move = m_searcher.getMove(m_position, m_history, thinkTimeMS);
 	const std::string url = std::format(k_makeMoveURL, m_id, Chess::Utils::moveToStr(move));
 	const std::string_view header = Authorization::instance().getAuthorizationHeader();
 	const Curl curl = Curl::post(url, { header }, {});
@@ -14,6 +14,7 @@ public:
 private:
 	Chess::Searcher m_searcher{};
 	Chess::Position m_position;
+	Chess::GameHistory m_history;
 	Chess::PieceColor m_color;
 
 	std::string m_id;
@@ -1,3 +1,4 @@
+#include <exception>
 #include <iostream>
 #include <string>
 #include "StreamHandler.hpp"
@@ -10,6 +11,16 @@ std::thread::id g_mainThreadId;
 int main(int argc, char** argv) {
 	LOG("Initializing chess engine");
 	Chess::init();
+	// an optional network file replaces the hand written evaluation
+	if (argc > 1) {
+		LOG("Loading network ", argv[1]);
+		try {
+			Chess::Nnue::load(argv[1]);
+		}
+		catch (const std::exception& e) {
+			LOG("Failed to load network, using the hand written evaluation: ", e.what());
+		}
+	}
 	Curl::init();
 
 	g_mainThreadId = std::this_thread::get_id();
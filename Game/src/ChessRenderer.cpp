@@ -113,9 +113,9 @@ void ChessRenderer::drawLegalMoves(const GameManager& gm) {
     const Chess::MoveList& legalMoves{ gm.getLegalMoves() };
     for (int i = 0; i < legalMoves.size(); i++) {
         Chess::Move move = legalMoves[i];
-        if (move.start == selectedSquare) {
+        if (move.start() == selectedSquare) {
             m_renderer.setDrawColor(legalMoveColor);
-            Rect rect = gameSquareToDrawRect(move.target, player->getColor());
+            Rect rect = gameSquareToDrawRect(move.target(), player->getColor());
             m_renderer.fillRect(rect);
         }
     }
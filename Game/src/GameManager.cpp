@@ -23,8 +23,9 @@ GameManager::GameManager(GameType gameType) : m_gameType{ gameType }, m_callback
         break;
     }
     m_position = Chess::Position::defaultPosition();
-    m_whitePlayer->updatePosition(m_position);
-    m_blackPlayer->updatePosition(m_position);
+    m_history = Chess::GameHistory{ m_position };
+    m_whitePlayer->updatePosition(m_position, m_history);
+    m_blackPlayer->updatePosition(m_position, m_history);
     Chess::MoveGenerator::generateLegal(m_position, m_legalMoves);
 
     if (m_position.getTurn() == Chess::PieceColor::White) {
@@ -59,18 +60,17 @@ void GameManager::onMove(const Player& player, Chess::Move move) {
     if (player.getColor() != m_position.getTurn()) {
         return;
     }
-    // auto queen promotion for user
-    if (m_position.getPieceAt(move.start).type == Chess::PieceType::Pawn &&
-        (move.target / 8 == 0 || move.target / 8 == 7) &&
-        move.promotion == Chess::PieceType::Null) {
-        move.promotion = Chess::PieceType::Queen;
-    }
     for (Chess::Move m : m_legalMoves) {
-        if (move == m) {
-            m_position.makeMove(move);
+        // a promotion must match exactly, otherwise the player only picked
+        // squares and the legal move fills in the rest, auto queening
+        const bool matches = move.isPromotion() ? m == move
+            : m.start() == move.start() && m.target() == move.target() &&
+            (!m.isPromotion() || m.promotion() == Chess::PieceType::Queen);
+        if (matches) {
+            m_history.makeMove(m_position, m);
             Chess::MoveGenerator::generateLegal(m_position, m_legalMoves);
-            m_whitePlayer->updatePosition(m_position);
-            m_blackPlayer->updatePosition(m_position);
+            m_whitePlayer->updatePosition(m_position, m_history);
+            m_blackPlayer->updatePosition(m_position, m_history);
             if (m_legalMoves.size() > 0) {
                 m_position.getTurn() == Chess::PieceColor::White ? m_whitePlayer->queryMove()
                     : m_blackPlayer->queryMove();
@@ -27,6 +27,7 @@ private:
 
 	Chess::MoveList m_legalMoves{};
 	Chess::Position m_position{};
+	Chess::GameHistory m_history{};
 
 	OnMoveCallback m_callbackHandler{};
 };
\ No newline at end of file
@@ -87,7 +87,7 @@ AIPlayer::AIPlayer(Chess::PieceColor color, const OnMoveCallback& callback)
 // make this functor
 void AIPlayer::queryMove() {
     std::thread t{ [this]() {
-      const Chess::Move move = m_searcher.getMove(*m_position);
+      const Chess::Move move = m_searcher.getMove(*m_position, *m_history);
       (*m_callback)(*this, move);
     }};
     t.detach();
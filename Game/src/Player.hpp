@@ -15,7 +15,10 @@ public:
     Player(Chess::PieceColor color, const OnMoveCallback& callback) : m_color{ color }, m_callback{ &callback } {};
     virtual ~Player() = default;
 
-    void updatePosition(const Chess::Position& position) { m_position = &position; };
+    void updatePosition(const Chess::Position& position, const Chess::GameHistory& history) {
+        m_position = &position;
+        m_history = &history;
+    };
     void reseatCallback(const OnMoveCallback& callback) { m_callback = &callback;  }
 
     Chess::PieceColor getColor() const { return m_color; };
@@ -25,6 +28,7 @@ public:
 protected:
     Chess::PieceColor m_color;
     const Chess::Position* m_position{nullptr};
+    const Chess::GameHistory* m_history{nullptr};
     const OnMoveCallback* m_callback;
 };
 
@@ -0,0 +1,93 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+namespace {
+    constexpr int k_defaultSuiteDepth = 5;
+
+    void printUsage() {
+        std::cerr << "Usage: Perft [options] <depth> [fen | startpos]\n"
+            "       Perft [options] suite [max depth]\n"
+            "Options: --threads <n>, --hash <MB> (default 64, 0 disables it),\n"
+            "         --magic (skip PEXT slider lookups),\n"
+            "         --verify-checks (check givesCheck at every node instead of counting)\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Chess::Perft::Options options{};
+    bool forceMagic = false;
+    bool verifyChecks = false;
+    std::vector<std::string_view> args{};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--hash" && i + 1 < argc) {
+            options.hashMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--magic") {
+            forceMagic = true;
+        }
+        else if (arg == "--verify-checks") {
+            verifyChecks = true;
+        }
+        else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.empty() || options.threads <= 0) {
+        printUsage();
+        return 1;
+    }
+    Chess::init();
+    if (forceMagic) {
+        Chess::PregeneratedMoves::init(Chess::PregeneratedMoves::SliderIndexing::Magic);
+    }
+    std::cout << "Slider attacks: " << (Chess::PregeneratedMoves::getSliderIndexing() ==
+        Chess::PregeneratedMoves::SliderIndexing::Pext ? "pext" : "magic") << "\n\n";
+
+    if (args[0] == "suite") {
+        const int depth =
+            args.size() > 1 ? std::atoi(args[1].data()) : k_defaultSuiteDepth;
+        if (verifyChecks) {
+            return Chess::Perft::verifyChecksSuite(depth) ? 0 : 1;
+        }
+        return Chess::Perft::runSuite(depth, options) ? 0 : 1;
+    }
+
+    const int depth = std::atoi(args[0].data());
+    if (depth <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    std::string fen{ "startpos" };
+    if (args.size() > 1) {
+        fen = args[1];
+        for (size_t i = 2; i < args.size(); i++) {
+            fen += ' ';
+            fen += args[i];
+        }
+    }
+
+    try {
+        const Chess::Position position = Chess::Position::fromFen(fen);
+        if (verifyChecks) {
+            return Chess::Perft::verifyChecks(position, depth) ? 0 : 1;
+        }
+        Chess::Perft::divide(position, depth, options);
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+using Chess::SearchTrace;
+
+namespace {
+    constexpr int k_maxPly = 256;
+
+    struct Options {
+        std::string path;
+        int treePly = -1;
+        uint64_t treeRecords = 2000;
+    };
+
+    struct Summary {
+        uint64_t records = 0;
+        uint64_t byType[4]{};
+        uint64_t byReason[9]{};
+        uint64_t researches = 0;
+        uint64_t perPly[k_maxPly]{};
+        uint64_t quiescencePerPly[k_maxPly]{};
+        int maxPly = 0;
+    };
+
+    const char* typeName(SearchTrace::NodeType type) {
+        switch (type) {
+        case SearchTrace::NodeType::Root: return "root";
+        case SearchTrace::NodeType::PV: return "pv";
+        case SearchTrace::NodeType::NonPV: return "non-pv";
+        case SearchTrace::NodeType::Quiescence: return "qsearch";
+        }
+        return "?";
+    }
+
+    const char* reasonName(SearchTrace::Reason reason) {
+        switch (reason) {
+        case SearchTrace::Reason::Exact: return "exact";
+        case SearchTrace::Reason::FailLow: return "fail low";
+        case SearchTrace::Reason::BetaCutoff: return "beta cutoff";
+        case SearchTrace::Reason::StandPat: return "stand pat";
+        case SearchTrace::Reason::Transposition: return "tt cutoff";
+        case SearchTrace::Reason::Repetition: return "repetition";
+        case SearchTrace::Reason::Checkmate: return "checkmate";
+        case SearchTrace::Reason::Stalemate: return "stalemate";
+        case SearchTrace::Reason::TimeUp: return "time up";
+        }
+        return "?";
+    }
+
+    void printUsage() {
+        std::cerr << "Usage: TraceViewer <trace file> [--tree <max ply>] "
+            "[--tree-records <count>]\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& options) {
+        if (argc < 2) return false;
+        options.path = argv[1];
+        for (int i = 2; i < argc; i++) {
+            const std::string_view arg{ argv[i] };
+            if (arg == "--tree" && i + 1 < argc) {
+                options.treePly = std::atoi(argv[++i]);
+            }
+            else if (arg == "--tree-records" && i + 1 < argc) {
+                options.treeRecords = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void printPercent(uint64_t part, uint64_t total) {
+        const double percent = total ? 100.0 * part / total : 0.0;
+        std::cout << std::setw(7) << std::fixed << std::setprecision(2) << percent
+            << "%";
+    }
+
+    void printSummary(const Summary& summary) {
+        std::cout << "Records: " << summary.records << "\n\n";
+
+        std::cout << "Node types\n";
+        for (uint8_t i = 0; i < 4; i++) {
+            std::cout << "  " << std::left << std::setw(14)
+                << typeName(static_cast<SearchTrace::NodeType>(i)) << std::right
+                << std::setw(12) << summary.byType[i] << "  ";
+            printPercent(summary.byType[i], summary.records);
+            std::cout << '\n';
+        }
+        std::cout << "  " << std::left << std::setw(14) << "pvs re-search"
+            << std::right << std::setw(12) << summary.researches << "  ";
+        printPercent(summary.researches, summary.records);
+        std::cout << "\n\n";
+
+        std::cout << "Exit reasons\n";
+        for (uint8_t i = 0; i < 9; i++) {
+            std::cout << "  " << std::left << std::setw(14)
+                << reasonName(static_cast<SearchTrace::Reason>(i)) << std::right
+                << std::setw(12) << summary.byReason[i] << "  ";
+            printPercent(summary.byReason[i], summary.records);
+            std::cout << '\n';
+        }
+        std::cout << '\n';
+
+        std::cout << "Nodes per ply (ply, nodes, qsearch, branching)\n";
+        for (int ply = 0; ply <= summary.maxPly; ply++) {
+            std::cout << "  " << std::setw(3) << ply << std::setw(12)
+                << summary.perPly[ply] << std::setw(12)
+                << summary.quiescencePerPly[ply];
+            if (ply > 0 && summary.perPly[ply - 1]) {
+                std::cout << std::setw(10) << std::fixed << std::setprecision(2)
+                    << static_cast<double>(summary.perPly[ply]) /
+                    summary.perPly[ply - 1];
+            }
+            std::cout << '\n';
+        }
+    }
+
+    // Records arrive in post order, so a record at ply p adopts every pending
+    // record deeper than p. Walking back up the stack rebuilds pre order.
+    void printTree(const std::vector<SearchTrace::Record>& records, int maxPly) {
+        struct Node {
+            size_t record;
+            std::vector<size_t> children;
+        };
+        std::vector<Node> nodes{};
+        std::vector<size_t> pending{};
+        nodes.reserve(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            Node node{ i, {} };
+            while (!pending.empty() &&
+                records[nodes[pending.back()].record].ply > records[i].ply) {
+                node.children.insert(node.children.begin(), pending.back());
+                pending.pop_back();
+            }
+            nodes.push_back(std::move(node));
+            pending.push_back(nodes.size() - 1);
+        }
+
+        std::vector<size_t> stack{ pending.rbegin(), pending.rend() };
+        while (!stack.empty()) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            const SearchTrace::Record& r = records[node.record];
+            if (r.ply > maxPly) continue;
+            std::cout << std::string(2 * r.ply, ' ')
+                << (r.type == SearchTrace::NodeType::Root
+                    ? std::string{ "root" }
+                    : Chess::Utils::moveToStr(r.move))
+                << " [" << typeName(r.type) << (r.flags & SearchTrace::Research ? ", re-search" : "")
+                << "] d=" << static_cast<int>(r.depth) << " (" << r.alpha << ", "
+                << r.beta << ") -> " << r.score << ' ' << reasonName(r.reason) << '\n';
+            for (auto it = node.children.rbegin(); it != node.children.rend(); it++) {
+                stack.push_back(*it);
+            }
+        }
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options{};
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::ifstream file{ options.path, std::ios::binary };
+    if (!file) {
+        std::cerr << "Failed to open " << options.path << '\n';
+        return 1;
+    }
+
+    char header[SearchTrace::k_headerSize]{};
+    if (!file.read(header, sizeof(header)) ||
+        std::memcmp(header, SearchTrace::k_magic, sizeof(SearchTrace::k_magic)) != 0) {
+        std::cerr << options.path << " is not a search trace\n";
+        return 1;
+    }
+
+    Summary summary{};
+    std::vector<SearchTrace::Record> treeRecords{};
+    std::vector<char> buffer(SearchTrace::k_recordSize * 4096);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        const size_t count = static_cast<size_t>(file.gcount()) / SearchTrace::k_recordSize;
+        for (size_t i = 0; i < count; i++) {
+            const SearchTrace::Record r =
+                SearchTrace::decode(buffer.data() + i * SearchTrace::k_recordSize);
+            const int ply = r.ply < k_maxPly ? r.ply : k_maxPly - 1;
+            summary.records++;
+            summary.byType[static_cast<uint8_t>(r.type) & 3]++;
+            if (static_cast<uint8_t>(r.reason) < 9) {
+                summary.byReason[static_cast<uint8_t>(r.reason)]++;
+            }
+            if (r.flags & SearchTrace::Research) summary.researches++;
+            summary.perPly[ply]++;
+            if (r.type == SearchTrace::NodeType::Quiescence) {
+                summary.quiescencePerPly[ply]++;
+            }
+            if (ply > summary.maxPly) summary.maxPly = ply;
+            if (options.treePly >= 0 && treeRecords.size() < options.treeRecords) {
+                treeRecords.push_back(r);
+            }
+        }
+    }
+
+    printSummary(summary);
+    if (options.treePly >= 0) {
+        std::cout << "\nTree of the first " << treeRecords.size() << " records\n";
+        printTree(treeRecords, options.treePly);
+    }
+    return 0;
+}
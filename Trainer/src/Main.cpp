@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+#include "Network.hpp"
+#include "TrainingData.hpp"
+
+namespace {
+    void printUsage() {
+        std::cerr << "Usage: Trainer convert <text file> <binary file>\n"
+            "       Trainer train [options] <binary file> <network file>\n"
+            "Text lines are \"<fen> | <centipawns> | <1.0, 0.5 or 0.0>\" from white's side.\n"
+            "Options: --epochs <n>, --batch <n>, --lr <rate>, --lr-decay <factor>,\n"
+            "         --result-weight <0 to 1>, --threads <n>\n"
+            "The network file is rewritten after every epoch.\n";
+    }
+
+    int train(const std::vector<std::string_view>& args, const Trainer::Options& options) {
+        const std::vector<Trainer::PackedPosition> positions = Trainer::load(args[1]);
+        if (positions.empty()) {
+            throw std::runtime_error{ "No training positions" };
+        }
+        std::cout << "Positions: " << positions.size() << ", threads: " << options.threads
+            << '\n';
+
+        Chess::ThreadPool pool{ options.threads };
+        Trainer::Network network{};
+        float learningRate = options.learningRate;
+        for (int epoch = 1; epoch <= options.epochs; epoch++) {
+            const auto start = std::chrono::steady_clock::now();
+            const double loss = network.trainEpoch(positions, options, learningRate, pool);
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            network.save(args[2]);
+
+            std::cout << "Epoch " << epoch << ": loss " << loss << ", "
+                << static_cast<uint64_t>(positions.size() / elapsed.count())
+                << " positions/second\n";
+            learningRate *= options.learningRateDecay;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Trainer::Options options{};
+    std::vector<std::string_view> args{};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--epochs" && i + 1 < argc) {
+            options.epochs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            options.batchSize = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--lr" && i + 1 < argc) {
+            options.learningRate = std::strtof(argv[++i], nullptr);
+        }
+        else if (arg == "--lr-decay" && i + 1 < argc) {
+            options.learningRateDecay = std::strtof(argv[++i], nullptr);
+        }
+        else if (arg == "--result-weight" && i + 1 < argc) {
+            options.resultWeight = std::strtof(argv[++i], nullptr);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        }
+        else {
+            args.push_back(arg);
+        }
+    }
+
+    const bool convert = args.size() == 3 && args[0] == "convert";
+    const bool train = args.size() == 3 && args[0] == "train";
+    if ((!convert && !train) || options.epochs <= 0 || options.batchSize == 0 ||
+        options.threads <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    Chess::init();
+    try {
+        if (convert) {
+            std::cout << "Wrote " << Trainer::convert(args[1], args[2]) << " positions\n";
+            return 0;
+        }
+        return ::train(args, options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,207 @@
+#include "Network.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+using namespace Chess;
+
+namespace {
+    constexpr int k_hidden = Nnue::k_hidden;
+
+    constexpr float k_beta1 = 0.9f;
+    constexpr float k_beta2 = 0.999f;
+    constexpr float k_epsilon = 1e-8f;
+    // Keeps every quantized weight and any sum of 32 of them within int16,
+    // since the engine clips the hidden layer at k_qa
+    constexpr float k_maxWeight = 1.98f;
+
+    // inputs of the pieces on the board, side to move's perspective first
+    struct Features {
+        Array2D<uint16_t, 2, 32> indices;
+        int count;
+    };
+
+    Features decode(const Trainer::PackedPosition& position) {
+        const PieceColor turn = static_cast<PieceColor>(position.turn);
+        Features features{};
+        uint64_t occupied = position.occupied;
+        while (occupied) {
+            const uint8_t square = static_cast<uint8_t>(std::countr_zero(occupied));
+            occupied &= occupied - 1;
+            const int i = features.count++;
+            const uint8_t nibble = (position.pieces[i / 2] >> (4 * (i % 2))) & 0xF;
+            const PieceType type = static_cast<PieceType>(nibble & 0b111);
+            const PieceColor color = static_cast<PieceColor>(nibble >> 3);
+            features.indices[0][i] = Nnue::featureIndex(turn, type, color, square);
+            features.indices[1][i] = Nnue::featureIndex(oppositeColor(turn), type, color, square);
+        }
+        return features;
+    }
+
+    float sigmoid(float x) {
+        return 1.0f / (1.0f + std::exp(-x));
+    }
+
+    template <typename T>
+    void write(std::ofstream& out, T value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}  // namespace
+
+Trainer::Network::Network(uint64_t seed)
+    : m_params(k_numParams), m_momentum(k_numParams), m_velocity(k_numParams), m_rng{ seed } {
+    // about 30 pieces feed each hidden neuron, which keeps their sums near
+    // the clipped range to start with
+    std::uniform_real_distribution<float> features{ -0.15f, 0.15f };
+    std::uniform_real_distribution<float> output{ -0.05f, 0.05f };
+    for (size_t i = k_featureWeights; i < k_featureBiases; i++) {
+        m_params[i] = features(m_rng);
+    }
+    for (size_t i = k_outputWeights; i < k_outputBias; i++) {
+        m_params[i] = output(m_rng);
+    }
+}
+
+double Trainer::Network::backpropagate(const PackedPosition& position, float resultWeight,
+    std::vector<float>& gradient) const {
+    const Features features = decode(position);
+
+    Array2D<float, 2, k_hidden> accumulators;
+    float output = m_params[k_outputBias];
+    for (int side = 0; side < 2; side++) {
+        float* accumulator = accumulators[side].data();
+        std::copy_n(&m_params[k_featureBiases], k_hidden, accumulator);
+        for (int i = 0; i < features.count; i++) {
+            const float* weights = &m_params[k_featureWeights + features.indices[side][i] * k_hidden];
+            for (int j = 0; j < k_hidden; j++) {
+                accumulator[j] += weights[j];
+            }
+        }
+        const float* outputWeights = &m_params[k_outputWeights + side * k_hidden];
+        for (int j = 0; j < k_hidden; j++) {
+            output += std::clamp(accumulator[j], 0.0f, 1.0f) * outputWeights[j];
+        }
+    }
+
+    // the output is in units of Nnue::k_scale centipawns, like the score
+    // once it is squashed
+    const bool white = position.turn == static_cast<uint8_t>(PieceColor::White);
+    const float score = static_cast<float>(white ? position.score : -position.score);
+    const float result = (white ? position.result : 2 - position.result) / 2.0f;
+    const float target = resultWeight * result +
+        (1.0f - resultWeight) * sigmoid(score / Nnue::k_scale);
+    const float predicted = sigmoid(output);
+    const float error = predicted - target;
+
+    const float outputGradient = 2.0f * error * predicted * (1.0f - predicted);
+    gradient[k_outputBias] += outputGradient;
+    for (int side = 0; side < 2; side++) {
+        float* accumulator = accumulators[side].data();
+        const float* outputWeights = &m_params[k_outputWeights + side * k_hidden];
+        float* outputWeightGradients = &gradient[k_outputWeights + side * k_hidden];
+        for (int j = 0; j < k_hidden; j++) {
+            outputWeightGradients[j] += outputGradient * std::clamp(accumulator[j], 0.0f, 1.0f);
+            // reuse the accumulator for the gradient of the hidden sum, which
+            // is zero wherever the clipping was active
+            accumulator[j] = accumulator[j] > 0.0f && accumulator[j] < 1.0f
+                ? outputGradient * outputWeights[j] : 0.0f;
+            gradient[k_featureBiases + j] += accumulator[j];
+        }
+        for (int i = 0; i < features.count; i++) {
+            float* weightGradients =
+                &gradient[k_featureWeights + features.indices[side][i] * k_hidden];
+            for (int j = 0; j < k_hidden; j++) {
+                weightGradients[j] += accumulator[j];
+            }
+        }
+    }
+    return error * error;
+}
+
+void Trainer::Network::step(float learningRate, size_t batchSize, ThreadPool& pool) {
+    m_steps++;
+    const float momentumCorrection = 1.0f - std::pow(k_beta1, static_cast<float>(m_steps));
+    const float velocityCorrection = 1.0f - std::pow(k_beta2, static_cast<float>(m_steps));
+    const float scale = 1.0f / batchSize;
+
+    const size_t slice = (k_numParams + pool.size() - 1) / pool.size();
+    for (size_t start = 0; start < k_numParams; start += slice) {
+        const size_t end = std::min(start + slice, k_numParams);
+        pool.submit([=, this]() {
+            for (size_t i = start; i < end; i++) {
+                float sum = 0.0f;
+                for (std::vector<float>& gradient : m_gradients) {
+                    sum += gradient[i];
+                    gradient[i] = 0.0f;
+                }
+                const float g = sum * scale;
+                m_momentum[i] = k_beta1 * m_momentum[i] + (1.0f - k_beta1) * g;
+                m_velocity[i] = k_beta2 * m_velocity[i] + (1.0f - k_beta2) * g * g;
+                const float update = learningRate * (m_momentum[i] / momentumCorrection) /
+                    (std::sqrt(m_velocity[i] / velocityCorrection) + k_epsilon);
+                m_params[i] -= update;
+                if (i != k_outputBias) {
+                    m_params[i] = std::clamp(m_params[i], -k_maxWeight, k_maxWeight);
+                }
+            }
+        });
+    }
+    pool.wait();
+}
+
+double Trainer::Network::trainEpoch(const std::vector<PackedPosition>& positions,
+    const Options& options, float learningRate, ThreadPool& pool) {
+    std::vector<uint32_t> order(positions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), m_rng);
+
+    m_gradients.assign(pool.size(), std::vector<float>(k_numParams));
+    std::vector<double> losses(pool.size());
+
+    for (size_t batchStart = 0; batchStart < order.size(); batchStart += options.batchSize) {
+        const size_t batchEnd = std::min(batchStart + options.batchSize, order.size());
+        const size_t chunk = (batchEnd - batchStart + pool.size() - 1) / pool.size();
+        for (int thread = 0; thread < pool.size(); thread++) {
+            const size_t start = std::min(batchStart + thread * chunk, batchEnd);
+            const size_t end = std::min(start + chunk, batchEnd);
+            pool.submit([&, thread, start, end]() {
+                for (size_t i = start; i < end; i++) {
+                    losses[thread] += backpropagate(positions[order[i]], options.resultWeight,
+                        m_gradients[thread]);
+                }
+            });
+        }
+        pool.wait();
+        step(learningRate, batchEnd - batchStart, pool);
+    }
+    return std::accumulate(losses.begin(), losses.end(), 0.0) / positions.size();
+}
+
+void Trainer::Network::save(std::string_view path) const {
+    std::ofstream out{ std::string{ path }, std::ios::binary };
+    if (!out) {
+        throw std::runtime_error{ "Failed to open network file" };
+    }
+    const auto quantize = [](float value, float scale) {
+        return static_cast<int16_t>(std::lround(value * scale));
+    };
+
+    write(out, Nnue::k_magic);
+    write(out, static_cast<uint32_t>(k_hidden));
+    for (size_t i = k_featureWeights; i < k_outputWeights; i++) {
+        write(out, quantize(m_params[i], Nnue::k_qa));
+    }
+    for (size_t i = k_outputWeights; i < k_outputBias; i++) {
+        write(out, quantize(m_params[i], Nnue::k_qb));
+    }
+    write(out, static_cast<int32_t>(
+        std::lround(m_params[k_outputBias] * Nnue::k_qa * Nnue::k_qb)));
+    if (!out) {
+        throw std::runtime_error{ "Failed to write network file" };
+    }
+}
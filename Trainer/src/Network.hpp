@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+#include "TrainingData.hpp"
+
+namespace Trainer {
+    struct Options {
+        int epochs = 10;
+        size_t batchSize = 16384;
+        float learningRate = 0.001f;
+        // the learning rate is multiplied by this after every epoch
+        float learningRateDecay = 0.9f;
+        // share of the target taken from the game result, the rest from the score
+        float resultWeight = 0.5f;
+        int threads = Chess::ThreadPool::defaultThreads();
+    };
+
+    // The float counterpart of the engine's Chess::Nnue network, trained
+    // with Adam on minibatches split across threads. Only the inputs of the
+    // pieces on the board are visited, forwards and backwards.
+    class Network {
+    public:
+        explicit Network(uint64_t seed = 1);
+
+        // one pass over positions in a random order, returns the mean loss
+        double trainEpoch(const std::vector<PackedPosition>& positions,
+            const Options& options, float learningRate, Chess::ThreadPool& pool);
+
+        // quantized in the layout Chess::Nnue::load reads
+        void save(std::string_view path) const;
+
+    private:
+        // one flat parameter vector, so gradients and Adam are plain loops
+        static constexpr size_t k_featureWeights = 0;
+        static constexpr size_t k_featureBiases =
+            k_featureWeights + Chess::Nnue::k_inputs * Chess::Nnue::k_hidden;
+        static constexpr size_t k_outputWeights = k_featureBiases + Chess::Nnue::k_hidden;
+        static constexpr size_t k_outputBias = k_outputWeights + 2 * Chess::Nnue::k_hidden;
+        static constexpr size_t k_numParams = k_outputBias + 1;
+
+        std::vector<float> m_params;
+        // Adam's running first and second moments
+        std::vector<float> m_momentum;
+        std::vector<float> m_velocity;
+        uint64_t m_steps{ 0 };
+        // a gradient buffer per thread, summed into the first after a batch
+        std::vector<std::vector<float>> m_gradients{};
+        std::mt19937_64 m_rng;
+
+        // adds the gradient of one position to gradient and returns its loss
+        double backpropagate(const PackedPosition& position, float resultWeight,
+            std::vector<float>& gradient) const;
+        void step(float learningRate, size_t batchSize, Chess::ThreadPool& pool);
+    };
+}
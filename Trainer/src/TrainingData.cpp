@@ -0,0 +1,103 @@
+#include "TrainingData.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using namespace Chess;
+
+namespace {
+    std::string_view trim(std::string_view str) {
+        const size_t start = str.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos) {
+            return {};
+        }
+        return str.substr(start, str.find_last_not_of(" \t\r") - start + 1);
+    }
+
+    uint8_t parseResult(std::string_view str) {
+        if (str == "1.0" || str == "1") return 2;
+        if (str == "0.5") return 1;
+        if (str == "0.0" || str == "0") return 0;
+        throw std::invalid_argument{ "Invalid result " + std::string{ str } };
+    }
+}  // namespace
+
+Trainer::PackedPosition Trainer::pack(const Position& position, int score, uint8_t result) {
+    PackedPosition packed{};
+    packed.score = static_cast<int16_t>(std::clamp(score, -32000, 32000));
+    packed.result = result;
+    packed.turn = static_cast<uint8_t>(position.getTurn());
+
+    Bitboard occupied = position.getColorBitboard(PieceColor::White) |
+        position.getColorBitboard(PieceColor::Black);
+    if (occupied.numBits() > 32) {
+        throw std::invalid_argument{ "Too many pieces to pack" };
+    }
+    packed.occupied = occupied.get();
+    int index = 0;
+    while (occupied) {
+        const Piece piece = position.getPieceAt(occupied.popLSB());
+        const uint8_t nibble = static_cast<uint8_t>(piece.color) << 3 |
+            static_cast<uint8_t>(piece.type);
+        packed.pieces[index / 2] |= nibble << (4 * (index % 2));
+        index++;
+    }
+    return packed;
+}
+
+uint64_t Trainer::convert(std::string_view textPath, std::string_view binaryPath) {
+    std::ifstream in{ std::string{ textPath } };
+    std::ofstream out{ std::string{ binaryPath }, std::ios::binary };
+    if (!in || !out) {
+        throw std::runtime_error{ "Failed to open training data" };
+    }
+
+    uint64_t count = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (trim(line).empty()) {
+            continue;
+        }
+        const std::vector<std::string> fields = Utils::split(line, '|');
+        if (fields.size() != 3) {
+            throw std::invalid_argument{ "Expected <fen> | <score> | <result>: " + line };
+        }
+        const std::string_view scoreField = trim(fields[1]);
+        int score = 0;
+        const auto [end, error] = std::from_chars(scoreField.data(),
+            scoreField.data() + scoreField.size(), score);
+        if (error != std::errc{} || end != scoreField.data() + scoreField.size()) {
+            throw std::invalid_argument{ "Invalid score: " + line };
+        }
+
+        const PackedPosition packed = pack(Position::fromFen(trim(fields[0])), score,
+            parseResult(trim(fields[2])));
+        out.write(reinterpret_cast<const char*>(&packed), sizeof(packed));
+        count++;
+    }
+    if (!out) {
+        throw std::runtime_error{ "Failed to write training data" };
+    }
+    return count;
+}
+
+std::vector<Trainer::PackedPosition> Trainer::load(std::string_view binaryPath) {
+    std::ifstream in{ std::string{ binaryPath }, std::ios::binary | std::ios::ate };
+    if (!in) {
+        throw std::runtime_error{ "Failed to open training data" };
+    }
+    const std::streamsize size = in.tellg();
+    if (size % sizeof(PackedPosition) != 0) {
+        throw std::runtime_error{ "Training data is not a whole number of positions" };
+    }
+    std::vector<PackedPosition> positions(size / sizeof(PackedPosition));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(positions.data()), size);
+    if (!in) {
+        throw std::runtime_error{ "Failed to read training data" };
+    }
+    return positions;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+namespace Trainer {
+    // One training position in 32 bytes. Pieces are listed in ascending
+    // square order as in Chess::Position, a8 first, one nibble each with the
+    // color in bit 3 and the PieceType below it.
+    struct PackedPosition {
+        uint64_t occupied;
+        Array<uint8_t, 16> pieces;
+        // centipawns from white's side
+        int16_t score;
+        // from white's side: 0 loss, 1 draw, 2 win
+        uint8_t result;
+        uint8_t turn;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(PackedPosition) == 32);
+
+    // throws std::invalid_argument for more than 32 pieces
+    PackedPosition pack(const Chess::Position& position, int score, uint8_t result);
+
+    // Reads lines of "<fen> | <centipawns> | <1.0, 0.5 or 0.0>", both from
+    // white's side, and writes them packed. Returns the number written,
+    // throws on an unreadable file or a malformed line.
+    uint64_t convert(std::string_view textPath, std::string_view binaryPath);
+
+    std::vector<PackedPosition> load(std::string_view binaryPath);
+}
@@ -0,0 +1,143 @@
+#include "Dataset.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+#include <EvalTrace.hpp>
+#include <Evaluator.hpp>
+
+#include "MappedFile.hpp"
+
+using namespace Chess;
+
+namespace {
+    // results as written in the c9 opcode and in bracketed form
+    struct ResultToken {
+        std::string_view text;
+        float result;
+    };
+
+    constexpr Array<ResultToken, 8> k_resultTokens = { {
+        { "1/2-1/2", 0.5f }, { "1-0", 1.0f }, { "0-1", 0.0f },
+        { "[0.5]", 0.5f }, { "[1.0]", 1.0f }, { "[0.0]", 0.0f },
+        { "[1]", 1.0f }, { "[0]", 0.0f } } };
+
+    std::optional<float> parseResult(std::string_view text) {
+        for (const ResultToken& token : k_resultTokens) {
+            if (text.find(token.text) != std::string_view::npos) {
+                return token.result;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool isNumber(std::string_view text) {
+        return !text.empty() && std::all_of(text.begin(), text.end(),
+            [](char c) { return c >= '0' && c <= '9'; });
+    }
+
+    // Splits a line into the FEN Position::fromFen reads and the rest. EPD
+    // leaves out the move counters, which are filled in when missing.
+    std::optional<std::pair<std::string, std::string_view>> splitLine(std::string_view line) {
+        std::vector<std::string_view> fields{};
+        size_t position = 0;
+        while (fields.size() < 6) {
+            const size_t start = line.find_first_not_of(' ', position);
+            if (start == std::string_view::npos) {
+                break;
+            }
+            const size_t end = std::min(line.find(' ', start), line.size());
+            fields.push_back(line.substr(start, end - start));
+            position = end;
+        }
+        if (fields.size() < 4) {
+            return std::nullopt;
+        }
+        std::string fen{};
+        for (size_t i = 0; i < 4; i++) {
+            fen.append(fields[i]).append(" ");
+        }
+        const bool counters = fields.size() == 6 && isNumber(fields[4]) && isNumber(fields[5]);
+        if (counters) {
+            fen.append(fields[4]).append(" ").append(fields[5]);
+        }
+        else {
+            fen += "0 1";
+            position = fields[3].data() + fields[3].size() - line.data();
+        }
+        return std::pair{ fen, line.substr(position) };
+    }
+
+    void parseChunk(std::string_view chunk, Tuner::Dataset& dataset) {
+        while (!chunk.empty()) {
+            const size_t end = std::min(chunk.find('\n'), chunk.size());
+            std::string_view line = chunk.substr(0, end);
+            chunk.remove_prefix(std::min(end + 1, chunk.size()));
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (line.find_first_not_of(' ') == std::string_view::npos) {
+                continue;
+            }
+
+            const auto split = splitLine(line);
+            const std::optional<float> result = split ? parseResult(split->second) : std::nullopt;
+            if (!result) {
+                dataset.skipped++;
+                continue;
+            }
+            EvalTrace trace{};
+            try {
+                trace = Evaluator::trace(Position::fromFen(split->first));
+            }
+            catch (const std::exception&) {
+                dataset.skipped++;
+                continue;
+            }
+
+            Tuner::Entry entry{ static_cast<uint32_t>(dataset.coefficients.size()), 0,
+                static_cast<uint8_t>(trace.phase), *result, trace.nonlinear };
+            for (size_t i = 0; i < EvalWeights::k_numScores; i++) {
+                if (trace.coefficients[i] != 0) {
+                    dataset.coefficients.push_back({ static_cast<uint16_t>(i),
+                        trace.coefficients[i] });
+                    entry.size++;
+                }
+            }
+            dataset.entries.push_back(entry);
+        }
+    }
+}  // namespace
+
+Tuner::Dataset Tuner::load(std::string_view path, ThreadPool& pool) {
+    const MappedFile file{ path };
+    const std::string_view contents = file.contents();
+
+    // several chunks per thread even out slow and fast parts of the file
+    const size_t chunks = static_cast<size_t>(pool.size()) * 4;
+    std::vector<Dataset> parts(chunks);
+    size_t start = 0;
+    for (size_t i = 0; i < chunks && start < contents.size(); i++) {
+        size_t end = std::min(contents.size(), start + contents.size() / chunks);
+        end = i + 1 == chunks ? contents.size() : contents.find('\n', end);
+        end = end == std::string_view::npos ? contents.size() : end;
+        const std::string_view chunk = contents.substr(start, end - start);
+        pool.submit([chunk, &part = parts[i]]() { parseChunk(chunk, part); });
+        start = end;
+    }
+    pool.wait();
+
+    Dataset dataset{};
+    for (Dataset& part : parts) {
+        const uint32_t offset = static_cast<uint32_t>(dataset.coefficients.size());
+        for (Entry& entry : part.entries) {
+            entry.first += offset;
+        }
+        dataset.entries.insert(dataset.entries.end(), part.entries.begin(), part.entries.end());
+        dataset.coefficients.insert(dataset.coefficients.end(), part.coefficients.begin(),
+            part.coefficients.end());
+        dataset.skipped += part.skipped;
+    }
+    return dataset;
+}
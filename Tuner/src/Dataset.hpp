@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+namespace Tuner {
+    // a weight that applies to a position, as an index into the flat
+    // EvalWeights vector and white's count minus black's
+    struct Coefficient {
+        uint16_t index;
+        int16_t count;
+    };
+
+    // A position reduced to what the tuner needs: its nonzero coefficients,
+    // the part of the evaluation that is not tuned, its phase and the game
+    // result from white's side
+    struct Entry {
+        uint32_t first;
+        uint16_t size;
+        uint8_t phase;
+        float result;
+        Chess::Score nonlinear;
+    };
+
+    struct Dataset {
+        std::vector<Entry> entries;
+        // the coefficients of every entry back to back
+        std::vector<Coefficient> coefficients;
+        // lines without a readable position or result
+        uint64_t skipped{ 0 };
+    };
+
+    // Reads an EPD file with the result of each position's game, either as
+    // c9 "1-0", "0-1" or "1/2-1/2" or as [1.0], [0.5] or [0.0]. The file is
+    // mapped and parsed in one chunk per thread of pool. Throws if the file
+    // cannot be read.
+    Dataset load(std::string_view path, Chess::ThreadPool& pool);
+}
@@ -0,0 +1,45 @@
+#include "HeaderWriter.hpp"
+
+#include <array>
+#include <bit>
+
+using namespace Chess;
+
+namespace {
+    constexpr size_t k_scoresPerLine = 4;
+
+    void writeScore(Score score, std::ostream& out) {
+        out << "Score{ " << score.middlegame() << ", " << score.endgame() << " }";
+    }
+}  // namespace
+
+void Tuner::writeHeader(const EvalWeights::Weights& weights, std::ostream& out) {
+    const auto scores = std::bit_cast<std::array<Score, EvalWeights::k_numScores>>(weights);
+
+    out << "#pragma once\n\n"
+        "// Generated by the Tuner tool, rerun it rather than editing by hand\n\n"
+        "#include \"EvalWeights.hpp\"\n"
+        "#include \"Score.hpp\"\n\n"
+        "namespace Chess {\n"
+        "    namespace EvalWeights {\n"
+        "        inline constexpr Weights weights = {\n";
+    for (const EvalWeights::Parameter& parameter : EvalWeights::parameters) {
+        out << "            // " << parameter.name << '\n';
+        if (parameter.size == 1) {
+            out << "            ";
+            writeScore(scores[parameter.offset], out);
+            out << ",\n";
+            continue;
+        }
+        out << "            {";
+        for (size_t i = 0; i < parameter.size; i++) {
+            out << (i % k_scoresPerLine == 0 ? "\n                " : " ");
+            writeScore(scores[parameter.offset + i], out);
+            out << (i + 1 < parameter.size ? "," : "");
+        }
+        out << " },\n";
+    }
+    out << "        };\n"
+        "    }  // namespace EvalWeights\n"
+        "}\n";
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <ostream>
+
+#include <EvalWeights.hpp>
+
+namespace Tuner {
+    // Writes weights as TunedWeights.hpp, one initializer per
+    // EvalWeights::parameters entry
+    void writeHeader(const Chess::EvalWeights::Weights& weights, std::ostream& out);
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Chess.hpp>
+
+#include "Dataset.hpp"
+#include "HeaderWriter.hpp"
+#include "Optimizer.hpp"
+
+namespace {
+    // epochs between progress lines and rewrites of the header
+    constexpr int k_reportInterval = 50;
+
+    void printUsage() {
+        std::cerr << "Usage: Tuner [options] <epd file> <output header>\n"
+            "EPD lines carry their game's result as c9 \"1-0\", \"0-1\" or \"1/2-1/2\",\n"
+            "or as [1.0], [0.5] or [0.0], from white's side.\n"
+            "Options: --epochs <n>, --lr <centipawns>, --threads <n>\n"
+            "The output is a replacement for ChessEngine/src/TunedWeights.hpp,\n"
+            "rewritten every " << k_reportInterval << " epochs.\n";
+    }
+
+    void save(const Tuner::Optimizer& optimizer, std::string_view path) {
+        std::ofstream out{ std::string{ path } };
+        if (!out) {
+            throw std::runtime_error{ "Failed to open output header" };
+        }
+        Tuner::writeHeader(optimizer.weights(), out);
+    }
+
+    int tune(const std::vector<std::string_view>& args, const Tuner::Options& options) {
+        Chess::ThreadPool pool{ options.threads };
+        const auto loadStart = std::chrono::steady_clock::now();
+        const Tuner::Dataset dataset = Tuner::load(args[0], pool);
+        const std::chrono::duration<double> loadTime =
+            std::chrono::steady_clock::now() - loadStart;
+        if (dataset.entries.empty()) {
+            throw std::runtime_error{ "No tuning positions" };
+        }
+        std::cout << "Positions: " << dataset.entries.size() << " (" << dataset.skipped
+            << " lines skipped), loaded in " << loadTime.count() << "s, threads: "
+            << options.threads << '\n';
+
+        Tuner::Optimizer optimizer{ dataset, pool };
+        const double initialLoss = optimizer.fitScale();
+        std::cout << "K: " << optimizer.scale() << ", loss: " << initialLoss << '\n';
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int epoch = 1; epoch <= options.epochs; epoch++) {
+            const double loss = optimizer.epoch(options.learningRate);
+            if (epoch % k_reportInterval == 0 || epoch == options.epochs) {
+                const std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                save(optimizer, args[1]);
+                std::cout << "Epoch " << epoch << ": loss " << loss << ", "
+                    << elapsed.count() / epoch << "s/epoch\n";
+            }
+        }
+        save(optimizer, args[1]);
+        std::cout << "Final loss: " << optimizer.loss() << '\n';
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Tuner::Options options{};
+    std::vector<std::string_view> args{};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--epochs" && i + 1 < argc) {
+            options.epochs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--lr" && i + 1 < argc) {
+            options.learningRate = std::strtod(argv[++i], nullptr);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        }
+        else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() != 2 || options.epochs < 0 || options.threads <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    Chess::init();
+    try {
+        return tune(args, options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
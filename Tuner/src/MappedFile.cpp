@@ -0,0 +1,74 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Tuner;
+
+#ifdef _WIN32
+MappedFile::MappedFile(std::string_view path) {
+    m_file = CreateFileA(std::string{ path }.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size{};
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size)) {
+        m_file = nullptr;
+        throw std::runtime_error{ "Failed to open " + std::string{ path } };
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) {
+        return;
+    }
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping
+        ? static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0))
+        : nullptr;
+    if (!m_data) {
+        if (m_mapping) CloseHandle(m_mapping);
+        CloseHandle(m_file);
+        throw std::runtime_error{ "Failed to map " + std::string{ path } };
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+}
+#else
+MappedFile::MappedFile(std::string_view path) {
+    m_descriptor = open(std::string{ path }.c_str(), O_RDONLY);
+    struct stat status {};
+    if (m_descriptor < 0 || fstat(m_descriptor, &status) != 0) {
+        if (m_descriptor >= 0) close(m_descriptor);
+        throw std::runtime_error{ "Failed to open " + std::string{ path } };
+    }
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size == 0) {
+        return;
+    }
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_descriptor, 0);
+    if (data == MAP_FAILED) {
+        close(m_descriptor);
+        throw std::runtime_error{ "Failed to map " + std::string{ path } };
+    }
+    // read front to back by each parsing thread
+    madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(data);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+    close(m_descriptor);
+}
+#endif
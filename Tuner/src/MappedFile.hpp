@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace Tuner {
+    // A whole file mapped read only into memory, so millions of positions
+    // can be parsed in place by several threads at once
+    class MappedFile {
+    public:
+        // throws std::runtime_error if the file cannot be opened or mapped
+        explicit MappedFile(std::string_view path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view contents() const { return { m_data, m_size }; }
+
+    private:
+        const char* m_data{ nullptr };
+        size_t m_size{ 0 };
+#ifdef _WIN32
+        void* m_file{ nullptr };
+        void* m_mapping{ nullptr };
+#else
+        int m_descriptor{ -1 };
+#endif
+    };
+}
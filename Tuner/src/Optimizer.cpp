@@ -0,0 +1,163 @@
+#include "Optimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+#include <PieceTables.hpp>
+
+using namespace Chess;
+
+namespace {
+    constexpr double k_beta1 = 0.9;
+    constexpr double k_beta2 = 0.999;
+    constexpr double k_epsilon = 1e-8;
+
+    constexpr double k_maxPhase = PieceTables::k_maxPhase;
+
+    double expectedScore(double evaluation, double scale) {
+        return 1.0 / (1.0 + std::pow(10.0, -scale * evaluation / 400.0));
+    }
+
+    // Runs task over one slice of [0, size) per thread and sums the results
+    double sumSlices(size_t size, ThreadPool& pool,
+        const std::function<double(size_t, size_t, int)>& task) {
+        std::vector<double> sums(pool.size());
+        const size_t slice = (size + pool.size() - 1) / pool.size();
+        for (int thread = 0; thread < pool.size(); thread++) {
+            const size_t start = std::min(thread * slice, size);
+            const size_t end = std::min(start + slice, size);
+            pool.submit([&, start, end, thread]() { sums[thread] = task(start, end, thread); });
+        }
+        pool.wait();
+        return std::accumulate(sums.begin(), sums.end(), 0.0);
+    }
+}  // namespace
+
+Tuner::Optimizer::Optimizer(const Dataset& dataset, ThreadPool& pool)
+    : m_dataset{ dataset }, m_pool{ pool }, m_params(2 * EvalWeights::k_numScores),
+    m_momentum(m_params.size()), m_velocity(m_params.size()) {
+    const auto scores =
+        std::bit_cast<std::array<Score, EvalWeights::k_numScores>>(EvalWeights::weights);
+    for (size_t i = 0; i < scores.size(); i++) {
+        m_params[2 * i] = scores[i].middlegame();
+        m_params[2 * i + 1] = scores[i].endgame();
+    }
+}
+
+double Tuner::Optimizer::evaluate(const Entry& entry) const {
+    double middlegame = entry.nonlinear.middlegame();
+    double endgame = entry.nonlinear.endgame();
+    for (uint32_t i = entry.first; i < entry.first + entry.size; i++) {
+        const Coefficient coefficient = m_dataset.coefficients[i];
+        middlegame += coefficient.count * m_params[2 * coefficient.index];
+        endgame += coefficient.count * m_params[2 * coefficient.index + 1];
+    }
+    return (middlegame * entry.phase + endgame * (k_maxPhase - entry.phase)) / k_maxPhase;
+}
+
+double Tuner::Optimizer::loss(double scale) {
+    const std::vector<Entry>& entries = m_dataset.entries;
+    return sumSlices(entries.size(), m_pool, [&](size_t start, size_t end, int) {
+        double sum = 0.0;
+        for (size_t i = start; i < end; i++) {
+            const double error = entries[i].result - expectedScore(evaluate(entries[i]), scale);
+            sum += error * error;
+        }
+        return sum;
+    }) / entries.size();
+}
+
+double Tuner::Optimizer::loss() {
+    return loss(m_scale);
+}
+
+double Tuner::Optimizer::fitScale() {
+    // the loss is unimodal in K, so a golden section search finds it
+    constexpr double k_ratio = 0.6180339887498949;
+    double low = 0.0;
+    double high = 4.0;
+    double left = high - k_ratio * (high - low);
+    double right = low + k_ratio * (high - low);
+    double leftLoss = loss(left);
+    double rightLoss = loss(right);
+    while (high - low > 1e-4) {
+        if (leftLoss < rightLoss) {
+            high = right;
+            right = left;
+            rightLoss = leftLoss;
+            left = high - k_ratio * (high - low);
+            leftLoss = loss(left);
+        }
+        else {
+            low = left;
+            left = right;
+            leftLoss = rightLoss;
+            right = low + k_ratio * (high - low);
+            rightLoss = loss(right);
+        }
+    }
+    m_scale = (low + high) / 2;
+    return loss(m_scale);
+}
+
+double Tuner::Optimizer::epoch(double learningRate) {
+    const std::vector<Entry>& entries = m_dataset.entries;
+    m_gradients.resize(m_pool.size());
+    for (std::vector<double>& gradient : m_gradients) {
+        gradient.assign(m_params.size(), 0.0);
+    }
+
+    // d expectedScore / d evaluation is s * (1 - s) * K * ln(10) / 400
+    const double slope = m_scale * std::log(10.0) / 400.0;
+    const double loss = sumSlices(entries.size(), m_pool,
+        [&](size_t start, size_t end, int thread) {
+            std::vector<double>& gradient = m_gradients[thread];
+            double sum = 0.0;
+            for (size_t i = start; i < end; i++) {
+                const Entry& entry = entries[i];
+                const double expected = expectedScore(evaluate(entry), m_scale);
+                const double error = expected - entry.result;
+                sum += error * error;
+                const double outer = 2.0 * error * expected * (1.0 - expected) * slope;
+                const double middlegame = outer * entry.phase / k_maxPhase;
+                const double endgame = outer * (k_maxPhase - entry.phase) / k_maxPhase;
+                for (uint32_t j = entry.first; j < entry.first + entry.size; j++) {
+                    const Coefficient coefficient = m_dataset.coefficients[j];
+                    gradient[2 * coefficient.index] += coefficient.count * middlegame;
+                    gradient[2 * coefficient.index + 1] += coefficient.count * endgame;
+                }
+            }
+            return sum;
+        }) / entries.size();
+
+    m_steps++;
+    const double momentumCorrection = 1.0 - std::pow(k_beta1, static_cast<double>(m_steps));
+    const double velocityCorrection = 1.0 - std::pow(k_beta2, static_cast<double>(m_steps));
+    for (size_t i = 0; i < m_params.size(); i++) {
+        double g = 0.0;
+        for (const std::vector<double>& gradient : m_gradients) {
+            g += gradient[i];
+        }
+        g /= entries.size();
+        m_momentum[i] = k_beta1 * m_momentum[i] + (1.0 - k_beta1) * g;
+        m_velocity[i] = k_beta2 * m_velocity[i] + (1.0 - k_beta2) * g * g;
+        m_params[i] -= learningRate * (m_momentum[i] / momentumCorrection) /
+            (std::sqrt(m_velocity[i] / velocityCorrection) + k_epsilon);
+    }
+    return loss;
+}
+
+EvalWeights::Weights Tuner::Optimizer::weights() const {
+    const auto round = [](double value) {
+        return static_cast<int>(std::clamp(std::round(value), -32768.0, 32767.0));
+    };
+    std::array<Score, EvalWeights::k_numScores> scores{};
+    for (size_t i = 0; i < scores.size(); i++) {
+        scores[i] = Score{ round(m_params[2 * i]), round(m_params[2 * i + 1]) };
+    }
+    return std::bit_cast<EvalWeights::Weights>(scores);
+}
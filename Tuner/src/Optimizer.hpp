@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include <Chess.hpp>
+#include <EvalWeights.hpp>
+
+#include "Dataset.hpp"
+
+namespace Tuner {
+    struct Options {
+        int epochs = 1000;
+        // in centipawns, roughly how far Adam moves a weight per epoch
+        double learningRate = 1.0;
+        int threads = Chess::ThreadPool::defaultThreads();
+    };
+
+    // Texel tuning: minimizes the mean squared difference between game
+    // results and the evaluation mapped to an expected score by
+    // 1 / (1 + 10^(-K * eval / 400)). The evaluation is linear in the
+    // weights, so every epoch is one exact gradient over the whole dataset,
+    // split across the threads of the pool, followed by an Adam step.
+    class Optimizer {
+    public:
+        // starts from the engine's current EvalWeights::weights
+        Optimizer(const Dataset& dataset, Chess::ThreadPool& pool);
+
+        // Fits K to the current weights and keeps it for later epochs.
+        // Returns the loss at the fitted K.
+        double fitScale();
+        double scale() const { return m_scale; }
+
+        double loss();
+        // one Adam step, returns the loss before the step
+        double epoch(double learningRate);
+
+        // rounded to whole centipawns
+        Chess::EvalWeights::Weights weights() const;
+
+    private:
+        const Dataset& m_dataset;
+        Chess::ThreadPool& m_pool;
+        // the middlegame then endgame value of every Score of the weights
+        std::vector<double> m_params;
+        // Adam's running first and second moments
+        std::vector<double> m_momentum;
+        std::vector<double> m_velocity;
+        uint64_t m_steps{ 0 };
+        double m_scale{ 1.0 };
+        // a gradient buffer per thread
+        std::vector<std::vector<double>> m_gradients{};
+
+        double evaluate(const Entry& entry) const;
+        double loss(double scale);
+    };
+}